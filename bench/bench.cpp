@@ -0,0 +1,419 @@
+#include "harness.hpp"
+
+#include <fftw-cpp/fftw-cpp.h>
+
+#include <complex>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Measures the cost of the wrapper against raw FFTW: plan creation per flag, execution of
+/// 1D/2D c2c and r2c transforms (power-of-two and awkward sizes), new-array execution against
+/// operator()(), compile-time size kernels against FFTW for small sizes, normalized inverse
+/// transforms against unnormalized ones and a division loop, fused r2c/filter/c2r pipelines
+/// against separate steps, Hermitian half-spectrum helpers against scalar loops, and buffer
+/// allocation.
+///
+/// Usage: fftw-cpp-bench [--filter=<substring>] [--min-time=<seconds>] [--repetitions=<n>]
+///                       [--out=<file.json>]
+/// JSON goes to --out (or stdout), a table to stderr.
+
+namespace {
+
+const std::vector<std::size_t> sizes_1d{256, 4096, 65536, 1000, 1536, 4099};
+const std::vector<std::pair<std::size_t, std::size_t>> sizes_2d{
+    {64, 64}, {512, 512}, {100, 100}, {250, 360}};
+
+std::string flag_name(fftw::Flags flags) {
+    switch (flags) {
+    case fftw::ESTIMATE:
+        return "ESTIMATE";
+    case fftw::MEASURE:
+        return "MEASURE";
+    case fftw::PATIENT:
+        return "PATIENT";
+    default:
+        break;
+    }
+    return "UNKNOWN";
+}
+
+std::string shape_name(std::size_t n, std::size_t m = 0) {
+    return m == 0 ? std::to_string(n) : std::to_string(n) + "x" + std::to_string(m);
+}
+
+void fill(auto *data, std::size_t size) {
+    for (std::size_t i = 0; i < size; ++i) {
+        data[i] = std::cos(double(i) / 7.0);
+    }
+}
+
+/// Cold planning: wisdom is forgotten before every plan, so MEASURE really measures.
+void bench_planning(bench::runner &runner) {
+    for (auto flags : {fftw::ESTIMATE, fftw::MEASURE}) {
+        for (std::size_t n : {1024ul, 1000ul}) {
+            fftw::buffer in(n), out(n);
+            runner.run_manual("plan/c2c_1d/" + flag_name(flags) + "/" + shape_name(n),
+                              [&](std::size_t iterations) {
+                                  bench::clock::duration total{};
+                                  for (std::size_t i = 0; i < iterations; ++i) {
+                                      fftw::wisdom::forget();
+                                      auto start = bench::clock::now();
+                                      auto p = fftw::plan<1u>::dft(in, out, fftw::FORWARD, flags);
+                                      total += bench::clock::now() - start;
+                                      bench::do_not_optimize(p.c_plan());
+                                  }
+                                  return total;
+                              });
+        }
+
+        fftw::rmdbuffer<2u> r{256, 256};
+        fftw::mdbuffer<2u> c{256, 129};
+        runner.run_manual("plan/r2c_2d/" + flag_name(flags) + "/" + shape_name(256, 256),
+                          [&](std::size_t iterations) {
+                              bench::clock::duration total{};
+                              for (std::size_t i = 0; i < iterations; ++i) {
+                                  fftw::wisdom::forget();
+                                  auto start = bench::clock::now();
+                                  auto p = fftw::plan_r2c<2u>::dft(r.to_mdspan(), c.to_mdspan(),
+                                                                   flags);
+                                  total += bench::clock::now() - start;
+                                  bench::do_not_optimize(p.c_plan());
+                              }
+                              return total;
+                          });
+    }
+}
+
+void bench_c2c_1d(bench::runner &runner, fftw::Flags flags) {
+    for (auto n : sizes_1d) {
+        auto name = [&](const std::string &variant) {
+            return "execute/c2c_1d/" + shape_name(n) + "/" + variant;
+        };
+        fftw::buffer in(n), out(n), in2(n), out2(n);
+
+        {
+            auto *raw_in = fftw_alloc_complex(n), *raw_out = fftw_alloc_complex(n);
+            auto raw = fftw_plan_dft_1d(int(n), raw_in, raw_out, FFTW_FORWARD, flags);
+            std::memset(raw_in, 0, n * sizeof(fftw_complex));
+            runner.run(name("raw"), [&] { fftw_execute(raw); }, double(n));
+            fftw_destroy_plan(raw);
+            fftw_free(raw_in);
+            fftw_free(raw_out);
+        }
+
+        auto p = fftw::plan<1u>::dft(in, out, fftw::FORWARD, flags);
+        fill(in.data(), n);
+        fill(in2.data(), n);
+        runner.run(name("wrapper"), [&] { p(); }, double(n));
+        runner.run(name("wrapper_new_array"), [&] { p(in2, out2); }, double(n));
+    }
+}
+
+void bench_c2c_2d(bench::runner &runner, fftw::Flags flags) {
+    for (auto [n, m] : sizes_2d) {
+        auto name = [&](const std::string &variant) {
+            return "execute/c2c_2d/" + shape_name(n, m) + "/" + variant;
+        };
+        fftw::mdbuffer<2u> in{n, m}, out{n, m}, in2{n, m}, out2{n, m};
+
+        {
+            auto *raw_in = fftw_alloc_complex(n * m), *raw_out = fftw_alloc_complex(n * m);
+            auto raw = fftw_plan_dft_2d(int(n), int(m), raw_in, raw_out, FFTW_FORWARD, flags);
+            std::memset(raw_in, 0, n * m * sizeof(fftw_complex));
+            runner.run(name("raw"), [&] { fftw_execute(raw); }, double(n * m));
+            fftw_destroy_plan(raw);
+            fftw_free(raw_in);
+            fftw_free(raw_out);
+        }
+
+        auto p = fftw::plan<2u>::dft(in.to_mdspan(), out.to_mdspan(), fftw::FORWARD, flags);
+        fill(in.data(), n * m);
+        fill(in2.data(), n * m);
+        runner.run(name("wrapper"), [&] { p(); }, double(n * m));
+        runner.run(
+            name("wrapper_new_array"), [&] { p(in2.to_mdspan(), out2.to_mdspan()); },
+            double(n * m));
+    }
+}
+
+void bench_r2c(bench::runner &runner, fftw::Flags flags) {
+    for (auto n : sizes_1d) {
+        auto name = [&](const std::string &variant) {
+            return "execute/r2c_1d/" + shape_name(n) + "/" + variant;
+        };
+        fftw::rmdbuffer<1u> in{n}, in2{n};
+        fftw::mdbuffer<1u> out{n / 2 + 1}, out2{n / 2 + 1};
+
+        {
+            auto *raw_in = fftw_alloc_real(n);
+            auto *raw_out = fftw_alloc_complex(n / 2 + 1);
+            auto raw = fftw_plan_dft_r2c_1d(int(n), raw_in, raw_out, flags);
+            fill(raw_in, n);
+            runner.run(name("raw"), [&] { fftw_execute(raw); }, double(n));
+            fftw_destroy_plan(raw);
+            fftw_free(raw_in);
+            fftw_free(raw_out);
+        }
+
+        auto p = fftw::plan_r2c<1u>::dft(in.to_mdspan(), out.to_mdspan(), flags);
+        fill(in.data(), n);
+        fill(in2.data(), n);
+        runner.run(name("wrapper"), [&] { p(); }, double(n));
+        runner.run(
+            name("wrapper_new_array"), [&] { p(in2.to_mdspan(), out2.to_mdspan()); }, double(n));
+    }
+
+    for (auto [n, m] : sizes_2d) {
+        auto name = [&](const std::string &variant) {
+            return "execute/r2c_2d/" + shape_name(n, m) + "/" + variant;
+        };
+        fftw::rmdbuffer<2u> in{n, m};
+        fftw::mdbuffer<2u> out{n, m / 2 + 1};
+
+        {
+            auto *raw_in = fftw_alloc_real(n * m);
+            auto *raw_out = fftw_alloc_complex(n * (m / 2 + 1));
+            auto raw = fftw_plan_dft_r2c_2d(int(n), int(m), raw_in, raw_out, flags);
+            fill(raw_in, n * m);
+            runner.run(name("raw"), [&] { fftw_execute(raw); }, double(n * m));
+            fftw_destroy_plan(raw);
+            fftw_free(raw_in);
+            fftw_free(raw_out);
+        }
+
+        auto p = fftw::plan_r2c<2u>::dft(in.to_mdspan(), out.to_mdspan(), flags);
+        fill(in.data(), n * m);
+        runner.run(name("wrapper"), [&] { p(); }, double(n * m));
+    }
+}
+
+/// Small transforms of a compile-time size: basic_plan (fftw_execute) against basic_static_plan.
+template <std::size_t N> void bench_static_size(bench::runner &runner, fftw::Flags flags) {
+    auto name = [&](const std::string &variant) {
+        return "execute/c2c_1d_static/" + shape_name(N) + "/" + variant;
+    };
+    using view = fftw::MDSPAN::mdspan<std::complex<double>, fftw::extents<std::size_t, N>>;
+    fftw::buffer in(N), out(N);
+    fill(in.data(), N);
+    view in_view{in.data()}, out_view{out.data()};
+
+    auto p = fftw::plan<1u>::dft(in_view, out_view, fftw::FORWARD, flags);
+    runner.run(name("wrapper"), [&] { p(); }, double(N));
+
+    auto s = fftw::static_plan<N>::dft(in_view, out_view, fftw::FORWARD);
+    runner.run(name("static"), [&] { s(); }, double(N));
+}
+
+void bench_static(bench::runner &runner, fftw::Flags flags) {
+    bench_static_size<8>(runner, flags);
+    bench_static_size<16>(runner, flags);
+    bench_static_size<32>(runner, flags);
+    bench_static_size<64>(runner, flags);
+}
+
+/// Inverse transforms without normalization, normalized by a division loop and normalized with
+/// basic_plan::normalize(). Both normalized variants make a second pass over the output, so their
+/// difference to the unnormalized transform is the cost of that pass, and their difference to
+/// each other is that of the vectorized multiplication against the division loop.
+void bench_normalization(bench::runner &runner, fftw::Flags flags) {
+    for (std::size_t n : {4096ul, 65536ul}) {
+        auto name = [&](const std::string &variant) {
+            return "normalize/c2c_1d/" + shape_name(n) + "/" + variant;
+        };
+        fftw::buffer in(n), out(n);
+        fill(in.data(), n);
+
+        auto p = fftw::plan<1u>::dft(in, out, fftw::BACKWARD, flags);
+        runner.run(name("unnormalized"), [&] { p(); }, double(n));
+        runner.run(name("division_loop"), [&] {
+            p();
+            for (auto &x : out) {
+                x /= double(n);
+            }
+        }, double(n));
+
+        auto normalized = fftw::plan<1u>::dft(in, out, fftw::BACKWARD, flags);
+        normalized.normalize(fftw::normalization::BACKWARD);
+        runner.run(name("normalized"), [&] { normalized(); }, double(n));
+    }
+
+    for (auto [n, m] : sizes_2d) {
+        auto name = [&](const std::string &variant) {
+            return "normalize/c2r_2d/" + shape_name(n, m) + "/" + variant;
+        };
+        fftw::mdbuffer<2u> in{n, m / 2 + 1};
+        fftw::rmdbuffer<2u> out{n, m};
+
+        // c2r destroys its input, so both variants transform whatever is left in it
+        auto p = fftw::plan_c2r<2u>::dft(in.to_mdspan(), out.to_mdspan(), flags);
+        fill(in.data(), in.size());
+        runner.run(name("unnormalized"), [&] { p(); }, double(n * m));
+        runner.run(name("division_loop"), [&] {
+            p();
+            for (std::size_t i = 0; i < out.size(); ++i) {
+                out.data()[i] /= double(n * m);
+            }
+        }, double(n * m));
+
+        auto normalized = fftw::plan_c2r<2u>::dft(in.to_mdspan(), out.to_mdspan(), flags);
+        normalized.normalize(fftw::normalization::BACKWARD);
+        fill(in.data(), in.size());
+        runner.run(name("normalized"), [&] { normalized(); }, double(n * m));
+    }
+}
+
+/// r2c, spectral filter and c2r as separate steps (each a full pass over memory) against
+/// basic_spectral_pipeline, which fuses the filter and the normalization into one pass.
+void bench_pipeline(bench::runner &runner, fftw::Flags flags) {
+    for (auto [n, m] : sizes_2d) {
+        auto name = [&](const std::string &variant) {
+            return "pipeline/r2c_filter_c2r/" + shape_name(n, m) + "/" + variant;
+        };
+        fftw::rmdbuffer<2u> in{n, m}, out{n, m};
+        fftw::mdbuffer<2u> spectrum{n, m / 2 + 1};
+        fftw::buffer filter(spectrum.size());
+        fill(in.data(), in.size());
+        fill(filter.data(), filter.size());
+
+        auto forward = fftw::plan_r2c<2u>::dft(in.to_mdspan(), spectrum.to_mdspan(), flags);
+        auto backward = fftw::plan_c2r<2u>::dft(spectrum.to_mdspan(), out.to_mdspan(), flags);
+        backward.normalize(fftw::normalization::BACKWARD);
+        runner.run(name("separate"), [&] {
+            forward();
+            for (std::size_t i = 0; i < spectrum.size(); ++i) {
+                spectrum.data()[i] *= filter[i];
+            }
+            backward();
+        }, double(n * m));
+
+        fftw::spectral_pipeline<2u> pipeline{{n, m}, flags};
+        pipeline.multiply(filter);
+        runner.run(name("fused"), [&] { pipeline(in, out); }, double(n * m));
+    }
+}
+
+/// Per-bin magnitude and full-spectrum expansion of r2c output: scalar loops against the
+/// Hermitian helpers.
+void bench_hermitian(bench::runner &runner) {
+    for (auto [n, m] : sizes_2d) {
+        auto name = [&](const std::string &op, const std::string &variant) {
+            return "hermitian/" + op + "/" + shape_name(n, m) + "/" + variant;
+        };
+        std::size_t mk = m / 2 + 1;
+        fftw::mdbuffer<2u> half{n, mk}, full{n, m};
+        fftw::rmdbuffer<2u> magnitude{n, mk};
+        fill(half.data(), half.size());
+
+        runner.run(name("magnitude", "scalar"), [&] {
+            for (std::size_t i = 0; i < n; ++i) {
+                for (std::size_t j = 0; j < mk; ++j) {
+                    magnitude(i, j) = std::abs(half(i, j));
+                }
+            }
+        }, double(n * mk));
+        runner.run(name("magnitude", "helper"), [&] { fftw::magnitude_spectrum(half, magnitude); },
+                   double(n * mk));
+
+        runner.run(name("expand", "scalar"), [&] {
+            for (std::size_t i = 0; i < n; ++i) {
+                for (std::size_t j = 0; j < m; ++j) {
+                    full(i, j) = j < mk ? half(i, j) : std::conj(half((n - i) % n, m - j));
+                }
+            }
+        }, double(n * m));
+        runner.run(name("expand", "helper"), [&] { fftw::expand_half_spectrum(half, full); },
+                   double(n * m));
+    }
+}
+
+void bench_allocation(bench::runner &runner) {
+    for (std::size_t n : {1024ul, 1ul << 20}) {
+        auto name = [&](const std::string &variant) {
+            return "alloc/" + shape_name(n) + "/" + variant;
+        };
+        runner.run(name("fftw_malloc"), [&] {
+            auto *p = fftw_alloc_complex(n);
+            bench::do_not_optimize(p);
+            fftw_free(p);
+        });
+        runner.run(name("buffer"), [&] {
+            fftw::buffer b(n);
+            bench::do_not_optimize(b.data());
+        });
+        runner.run(name("pooled_buffer"), [&] {
+            fftw::pooled_buffer b(n);
+            bench::do_not_optimize(b.data());
+        });
+        runner.run(name("mdbuffer"), [&] {
+            fftw::mdbuffer<2u> b{n / 32, 32};
+            bench::do_not_optimize(b.data());
+        });
+        // value-initializes, unlike the others
+        runner.run(name("std_vector"), [&] {
+            std::vector<std::complex<double>> v(n);
+            bench::do_not_optimize(v.data());
+        });
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    bench::options opts;
+    std::string out_file;
+    fftw::Flags flags = fftw::MEASURE;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](const std::string &prefix) { return arg.substr(prefix.size()); };
+        if (arg.starts_with("--filter=")) {
+            opts.filter = value("--filter=");
+        } else if (arg.starts_with("--min-time=")) {
+            opts.min_time = std::stod(value("--min-time="));
+        } else if (arg.starts_with("--repetitions=")) {
+            opts.repetitions = std::stoi(value("--repetitions="));
+        } else if (arg.starts_with("--out=")) {
+            out_file = value("--out=");
+        } else if (arg == "--estimate") {
+            flags = fftw::ESTIMATE; // faster startup, less representative execution times
+        } else {
+            std::cerr << "usage: " << argv[0]
+                      << " [--filter=<substring>] [--min-time=<seconds>] [--repetitions=<n>]"
+                         " [--out=<file.json>] [--estimate]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    bench::runner runner{opts};
+    bench_planning(runner);
+    bench_c2c_1d(runner, flags);
+    bench_c2c_2d(runner, flags);
+    bench_r2c(runner, flags);
+    bench_static(runner, flags);
+    bench_normalization(runner, flags);
+    bench_pipeline(runner, flags);
+    bench_hermitian(runner);
+    bench_allocation(runner);
+
+    runner.print_table(std::cerr);
+
+    std::vector<std::pair<std::string, std::string>> context{
+        {"library", "fftw-cpp"},
+        {"fftw_version", fftw_version},
+        {"execute_flags", flag_name(flags)},
+        {"num_cpus", std::to_string(std::thread::hardware_concurrency())},
+        {"min_time", std::to_string(opts.min_time)},
+        {"repetitions", std::to_string(opts.repetitions)},
+    };
+    if (out_file.empty()) {
+        runner.print_json(std::cout, context);
+    } else {
+        std::ofstream out{out_file};
+        runner.print_json(out, context);
+    }
+}
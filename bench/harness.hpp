@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// A minimal benchmark harness, so the benchmarks need nothing but the library itself.
+/// Output follows the Google Benchmark JSON format ("context" + "benchmarks"), so existing
+/// comparison tooling (e.g. compare.py) can be used on it.
+namespace bench {
+
+using clock = std::chrono::steady_clock;
+
+struct options {
+    std::string filter;     ///< only run benchmarks whose name contains this
+    double min_time{0.05};  ///< seconds per repetition
+    int repetitions{5};     ///< the median over repetitions is reported
+};
+
+struct result {
+    std::string name;
+    std::size_t iterations;
+    double median_ns; ///< per iteration
+    double min_ns;
+    double mean_ns;
+    double items_per_iteration; ///< e.g. elements per transform, 0 if not meaningful
+};
+
+/// Prevents the compiler from optimizing away a value.
+template <typename T> inline void do_not_optimize(T const &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+class runner {
+  public:
+    explicit runner(options opts) : opts(std::move(opts)) {}
+
+    /// Times body() in batches, growing the batch until it takes at least min_time.
+    template <typename Body> void run(const std::string &name, Body body, double items = 0.0) {
+        run_manual(
+            name,
+            [&](std::size_t iterations) {
+                auto start = clock::now();
+                for (std::size_t i = 0; i < iterations; ++i) {
+                    body();
+                }
+                return clock::now() - start;
+            },
+            items);
+    }
+
+    /// Like run, but timed(iterations) does its own timing and returns the elapsed time, so
+    /// setup that must happen before each iteration (e.g. forgetting wisdom) is excluded.
+    template <typename Timed>
+    void run_manual(const std::string &name, Timed timed, double items = 0.0) {
+        if (name.find(opts.filter) == std::string::npos) { return; }
+
+        auto min_time = std::chrono::duration<double>(opts.min_time);
+        std::size_t iterations = 1;
+        while (true) {
+            auto elapsed = std::chrono::duration<double>(timed(iterations));
+            if (elapsed >= min_time || iterations >= (std::size_t(1) << 30)) { break; }
+            // aim for 1.5x the minimum time, growing at most 10x at a time
+            double factor = elapsed.count() > 0 ? 1.5 * min_time / elapsed : 10.0;
+            iterations = std::max(iterations + 1, std::size_t(double(iterations) *
+                                                              std::min(factor, 10.0)));
+        }
+
+        std::vector<double> per_iteration;
+        for (int r = 0; r < opts.repetitions; ++r) {
+            std::chrono::duration<double, std::nano> elapsed = timed(iterations);
+            per_iteration.push_back(elapsed.count() / double(iterations));
+        }
+        std::ranges::sort(per_iteration);
+
+        double mean = 0.0;
+        for (auto t : per_iteration) {
+            mean += t / double(per_iteration.size());
+        }
+        results.push_back({name, iterations, per_iteration[per_iteration.size() / 2],
+                           per_iteration.front(), mean, items});
+    }
+
+    [[nodiscard]] const std::vector<result> &all() const { return results; }
+
+    /// Human-readable table.
+    void print_table(std::ostream &os) const {
+        os << std::left << std::setw(56) << "benchmark" << std::right << std::setw(14)
+           << "median ns" << std::setw(14) << "min ns" << std::setw(12) << "iterations" << '\n';
+        for (const auto &r : results) {
+            os << std::left << std::setw(56) << r.name << std::right << std::fixed
+               << std::setprecision(1) << std::setw(14) << r.median_ns << std::setw(14)
+               << r.min_ns << std::setw(12) << r.iterations << '\n';
+        }
+    }
+
+    void print_json(std::ostream &os,
+                    const std::vector<std::pair<std::string, std::string>> &context) const {
+        os << "{\n  \"context\": {";
+        for (std::size_t i = 0; i < context.size(); ++i) {
+            os << (i ? "," : "") << "\n    \"" << escape(context[i].first) << "\": \""
+               << escape(context[i].second) << '"';
+        }
+        os << "\n  },\n  \"benchmarks\": [";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const auto &r = results[i];
+            os << (i ? "," : "") << "\n    {\"name\": \"" << escape(r.name)
+               << "\", \"run_type\": \"aggregate\", \"aggregate_name\": \"median\""
+               << ", \"iterations\": " << r.iterations << ", \"real_time\": " << number(r.median_ns)
+               << ", \"cpu_time\": " << number(r.median_ns)
+               << ", \"min_time\": " << number(r.min_ns) << ", \"mean_time\": " << number(r.mean_ns)
+               << ", \"time_unit\": \"ns\"";
+            if (r.items_per_iteration > 0) {
+                os << ", \"items_per_second\": "
+                   << number(r.items_per_iteration / (r.median_ns * 1e-9));
+            }
+            os << "}";
+        }
+        os << "\n  ]\n}\n";
+    }
+
+  private:
+    static std::string escape(const std::string &s) {
+        std::string out;
+        for (char c : s) {
+            if (c == '"' || c == '\\') { out += '\\'; }
+            out += c;
+        }
+        return out;
+    }
+
+    static std::string number(double value) {
+        std::ostringstream ss;
+        ss << std::setprecision(6) << value;
+        return ss.str();
+    }
+
+    options opts;
+    std::vector<result> results;
+};
+
+} // namespace bench
@@ -7,11 +7,24 @@
 # - FFTW3_LIBRARIES, the library (and dependencies) to link against
 # - FFTW3::fftw3, an imported target for the library.
 #   This target also contains the proper include directories and dependencies needed
+# - FFTW3_<component>_FOUND, for every requested component
+# - FFTW3_<name>_LIBRARY and FFTW3::<name>, for every library found for the requested components,
+#   e.g. fftw3f, fftw3_threads or fftw3f_omp
+#
+# Components:
+# - float, long_double, quad: the single, long double and quad precision libraries
+#   (fftw3f, fftw3l, fftw3q). The double precision library fftw3 is always required.
+# - threads, the pthreads-based multithreaded library (fftw3_threads)
+# - omp, the OpenMP-based multithreaded library (fftw3_omp)
+# - mpi, the distributed-memory library (fftw3_mpi); MPI itself is not found here
+# These layers are found for every requested precision (e.g. fftw3f_threads) and are
+# linked in addition to the precision library.
 #
 # Hints:
 # - FFTW3_INCLUDE_DIR, where to find fftw3.h
 # - FFTW3_LIBRARY_DIR, where to find the library
 # - FFTW3_LIBRARY, the library to link against
+# - FFTW3_<name>_LIBRARY, any other library to link against, e.g. FFTW3_fftw3f_LIBRARY
 # Any number of hints can be passed. The remaining ones are inferred from the ones passed,
 # assuming the library is installed in a `lib` directory next to the `include` directory,
 # which contains the header file.
@@ -45,8 +58,67 @@ else ()
     endif ()
 endif ()
 
+# Finds one of the other FFTW3 libraries (e.g. fftw3f or fftw3_threads), preferring the directory
+# of the main library
+macro(_fftw3_find_library _name)
+    if (NOT FFTW3_${_name}_LIBRARY AND FFTW3_LIBRARY_DIR)
+        find_library(FFTW3_${_name}_LIBRARY NAMES ${_name} HINTS ${FFTW3_LIBRARY_DIR} NO_DEFAULT_PATH)
+    endif ()
+    if (NOT FFTW3_${_name}_LIBRARY)
+        find_library(FFTW3_${_name}_LIBRARY NAMES ${_name})
+    endif ()
+endmacro()
+
+set(_FFTW3_NAMES fftw3) # one library per precision
+set(_FFTW3_THREADING "") # threading and MPI layers, each built once per precision
+set(_FFTW3_float_NAME fftw3f)
+set(_FFTW3_long_double_NAME fftw3l)
+set(_FFTW3_quad_NAME fftw3q)
+foreach (_component IN LISTS FFTW3_FIND_COMPONENTS)
+    if (_component MATCHES "^(float|long_double|quad)$")
+        list(APPEND _FFTW3_NAMES ${_FFTW3_${_component}_NAME})
+    elseif (_component MATCHES "^(threads|omp|mpi)$")
+        list(APPEND _FFTW3_THREADING ${_component})
+    else ()
+        message(FATAL_ERROR "Unknown FFTW3 component: ${_component}")
+    endif ()
+endforeach ()
+
+set(_FFTW3_OTHER_NAMES "")
+foreach (_name IN LISTS _FFTW3_NAMES)
+    if (NOT _name STREQUAL "fftw3")
+        list(APPEND _FFTW3_OTHER_NAMES ${_name})
+    endif ()
+    foreach (_threading IN LISTS _FFTW3_THREADING)
+        list(APPEND _FFTW3_OTHER_NAMES ${_name}_${_threading})
+    endforeach ()
+endforeach ()
+
+foreach (_name IN LISTS _FFTW3_OTHER_NAMES)
+    _fftw3_find_library(${_name})
+endforeach ()
+
+# A precision component is found if its library is, a threading component if it was found for
+# every precision
+foreach (_component IN LISTS FFTW3_FIND_COMPONENTS)
+    set(FFTW3_${_component}_FOUND TRUE)
+    if (_component IN_LIST _FFTW3_THREADING)
+        foreach (_name IN LISTS _FFTW3_NAMES)
+            if (NOT FFTW3_${_name}_${_component}_LIBRARY)
+                set(FFTW3_${_component}_FOUND FALSE)
+            endif ()
+        endforeach ()
+    elseif (NOT FFTW3_${_FFTW3_${_component}_NAME}_LIBRARY)
+        set(FFTW3_${_component}_FOUND FALSE)
+    endif ()
+endforeach ()
+
 # handles REQUIRED, QUIET, output etc.
-find_package_handle_standard_args(FFTW3 DEFAULT_MSG FFTW3_LIBRARY FFTW3_INCLUDE_DIR)
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(FFTW3
+        REQUIRED_VARS FFTW3_LIBRARY FFTW3_INCLUDE_DIR
+        HANDLE_COMPONENTS
+)
 
 if (FFTW3_FOUND)
     # set the other output variables
@@ -73,5 +145,36 @@ if (FFTW3_FOUND)
         set(FFTW3_LIBRARIES ${FFTW3_LIBRARIES} m)
         target_link_libraries(FFTW3::fftw3 INTERFACE m)
     endif ()
+
+    foreach (_name IN LISTS _FFTW3_OTHER_NAMES)
+        if (NOT FFTW3_${_name}_LIBRARY)
+            continue ()
+        endif ()
+
+        if (FFTW3_${_name}_LIBRARY MATCHES ${STR_MATCH_REGEX})
+            add_library(FFTW3::${_name} STATIC IMPORTED)
+        else ()
+            add_library(FFTW3::${_name} SHARED IMPORTED)
+        endif ()
+        set_target_properties(FFTW3::${_name} PROPERTIES IMPORTED_LOCATION ${FFTW3_${_name}_LIBRARY})
+        target_include_directories(FFTW3::${_name} INTERFACE ${FFTW3_INCLUDE_DIRS})
+        if (UNIX)
+            target_link_libraries(FFTW3::${_name} INTERFACE m)
+        endif ()
+        if (_name MATCHES "^fftw3q")
+            # quad precision is implemented with libquadmath
+            target_link_libraries(FFTW3::${_name} INTERFACE quadmath)
+        endif ()
+        set(FFTW3_LIBRARIES ${FFTW3_${_name}_LIBRARY} ${FFTW3_LIBRARIES})
+    endforeach ()
+
+    # threading layers depend on the precision library they were built for
+    foreach (_name IN LISTS _FFTW3_NAMES)
+        foreach (_threading IN LISTS _FFTW3_THREADING)
+            if (TARGET FFTW3::${_name}_${_threading})
+                target_link_libraries(FFTW3::${_name}_${_threading} INTERFACE FFTW3::${_name})
+            endif ()
+        endforeach ()
+    endforeach ()
 endif ()
 
@@ -0,0 +1,55 @@
+#include <fftw-cpp/fftw-cpp.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <numbers>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Times a large 2D c2c transform for increasing thread counts.
+/// Usage: threads-scaling [N] [repetitions]
+int main(int argc, char **argv) {
+    std::size_t N = argc > 1 ? std::stoul(argv[1]) : 4096;
+    int repetitions = argc > 2 ? std::stoi(argv[2]) : 10;
+
+    if (!fftw::threads_supported()) {
+        std::cout << "fftw-cpp was built without FFTW threads (set FFTW_CPP_THREADS), "
+                     "all plans are single-threaded"
+                  << std::endl;
+    }
+
+    fftw::mdbuffer<2u> in{N, N}, out{N, N};
+    for (std::size_t j = 0; j < N; ++j) {
+        for (std::size_t k = 0; k < N; ++k) {
+            in(j, k) = {std::cos(2.0 * std::numbers::pi * double(j * k) / double(N)), 0.0};
+        }
+    }
+
+    int max_threads = int(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<int> thread_counts;
+    for (int threads = 1; threads < max_threads; threads *= 2) {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(max_threads);
+
+    double baseline = 0.0;
+    std::cout << "threads,ms_per_transform,speedup" << std::endl;
+    for (int threads : thread_counts) {
+        auto p = fftw::plan<2u>::dft(in.to_mdspan(), out.to_mdspan(), fftw::FORWARD,
+                                     fftw::ESTIMATE, threads);
+
+        p(); // warm up caches and thread pool
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < repetitions; ++i) {
+            p();
+        }
+        std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        double ms = elapsed.count() / repetitions;
+        if (threads == 1) { baseline = ms; }
+        std::cout << threads << "," << ms << "," << baseline / ms << std::endl;
+    }
+}
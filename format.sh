@@ -7,4 +7,4 @@ if [ $CHECK -eq 0 ]; then
 else
   FLAGS="--dry-run --Werror"
 fi
-find include/ examples/ test/ -name "*.cpp" -o -name "*.h" -o -name "*.hpp" | xargs clang-format-15 $FLAGS
+find include/ examples/ test/ bench/ -name "*.cpp" -o -name "*.h" -o -name "*.hpp" | xargs clang-format-15 $FLAGS
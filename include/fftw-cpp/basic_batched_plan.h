@@ -0,0 +1,463 @@
+#pragma once
+
+#include "basic_plan.h"
+#include "util.h"
+#include <array>
+#include <functional>
+#include <numeric>
+
+namespace fftw {
+
+/// Layouts a batched view can have: layout_right batches along the first (slowest) index,
+/// layout_left along the last (also slowest) index. Either way every transform is contiguous.
+template <typename Layout>
+concept batch_layout =
+    std::same_as<MDSPAN::layout_right, Layout> || std::same_as<MDSPAN::layout_left, Layout>;
+
+/// This concept checks that the view holds a batch of transforms of rank Rank - 1.
+template <typename View, size_t Rank, typename Element>
+concept batch_view = detail::mdspan_like<View> && View::rank() == Rank &&
+                     std::same_as<typename View::element_type, Element> &&
+                     batch_layout<typename View::layout_type>;
+
+/// Stride between consecutive elements of one transform and distance between the first elements
+/// of consecutive transforms, in elements, as in fftw_plan_many_dft.
+struct batch_stride {
+    int stride{1};
+    int dist{0};
+};
+
+namespace detail {
+
+/// A batch of `howmany` D-dimensional transforms, as passed to fftw_plan_many_dft.
+template <size_t D> struct batch_dims {
+    std::array<int, D> n; ///< extents of one transform, in row-major order
+    int howmany;
+    int dist;
+};
+
+template <size_t D> batch_dims<D> batch_extents(auto view) {
+    using layout = typename std::decay_t<decltype(view)>::layout_type;
+
+    batch_dims<D> result{};
+    if constexpr (std::same_as<MDSPAN::layout_right, layout>) {
+        for (size_t i = 0; i < D; ++i) {
+            result.n[i] = int(view.extent(i + 1));
+        }
+        result.howmany = int(view.extent(0));
+        result.dist = int(view.stride(0));
+    } else {
+        // column-major: the first index is the fastest, so reverse the transform extents
+        for (size_t i = 0; i < D; ++i) {
+            result.n[i] = int(view.extent(D - 1 - i));
+        }
+        result.howmany = int(view.extent(D));
+        result.dist = int(view.stride(D));
+    }
+    return result;
+}
+
+template <size_t D> auto dims_many(auto in, auto out) -> std::pair<batch_dims<D>, batch_dims<D>> {
+    auto Validate = [&](bool condition) {
+        if (!condition) { throw std::invalid_argument("Extents don't match"); }
+    };
+
+    auto in_dims = batch_extents<D>(in), out_dims = batch_extents<D>(out);
+    Validate(in_dims.howmany == out_dims.howmany);
+    Validate(in_dims.n == out_dims.n);
+
+    return {in_dims, out_dims};
+}
+
+template <size_t D> auto dims_many_r2c(auto r, auto c) -> std::pair<batch_dims<D>, batch_dims<D>> {
+    auto Validate = [&](bool condition) {
+        if (!condition) { throw std::invalid_argument("Extents don't match"); }
+    };
+
+    auto r_dims = batch_extents<D>(r), c_dims = batch_extents<D>(c);
+    Validate(r_dims.howmany == c_dims.howmany);
+    for (size_t i = 0; i + 1 < D; ++i) {
+        Validate(r_dims.n[i] == c_dims.n[i]);
+    }
+    Validate(r_dims.n[D - 1] / 2 + 1 == c_dims.n[D - 1]);
+
+    if (static_cast<const void *>(r.data_handle()) == static_cast<const void *>(c.data_handle())) {
+        throw std::invalid_argument("in-place batched real transforms are not supported");
+    }
+    return {r_dims, c_dims};
+}
+
+/// Checks that a buffer of `size` elements holds `howmany` transforms of extents `n`.
+template <size_t D>
+void validate_batch_span(size_t size, const std::array<int, D> &n, int howmany,
+                         batch_stride layout) {
+    auto count = std::accumulate(n.begin(), n.end(), std::int64_t{1}, std::multiplies<>{});
+    if (howmany < 1 || count < 1 || layout.stride < 1 || layout.dist < 0) {
+        throw std::invalid_argument("invalid batch layout");
+    }
+
+    auto last = std::int64_t(howmany - 1) * layout.dist + (count - 1) * layout.stride;
+    if (last >= std::int64_t(size)) { throw std::invalid_argument("batch exceeds buffer size"); }
+}
+
+template <size_t D> std::array<int, D> half_spectrum(std::array<int, D> n) {
+    n[D - 1] = n[D - 1] / 2 + 1;
+    return n;
+}
+
+} // namespace detail
+
+/// A plan for `howmany` independent D-dimensional c2c transforms of the same shape, planned once
+/// with fftw_plan_many_dft.
+/// The batch is either an mdspan of rank D + 1 (see batch_layout for which index is the batch) or
+/// a buffer with an explicit stride and distance between transforms.
+template <size_t D, class Real, class Complex = std::complex<Real>>
+class basic_batched_plan : public plan_base<D, Real, Complex> {
+  private:
+    using base = plan_base<D, Real, Complex>;
+    using plan_t = typename base::plan_t;
+
+  public:
+    using real_t = Real;
+    using complex_t = Complex;
+
+    using base::c_plan;
+    using base::plan_base;
+
+    /// Executes the plan with the buffers provided initially.
+    void operator()() const;
+
+    template <typename ViewIn, typename ViewOut>
+        requires batch_view<ViewIn, D + 1, Complex> && batch_view<ViewOut, D + 1, Complex>
+    void operator()(ViewIn in, ViewOut out) const;
+
+    template <typename BufferIn, typename BufferOut>
+        requires appropriate_buffers<1u, Real, Complex, BufferIn, BufferOut>
+    void operator()(BufferIn &in, BufferOut &out) const;
+
+    /// \defgroup{planning utilities}
+    template <typename ViewIn, typename ViewOut>
+        requires batch_view<ViewIn, D + 1, Complex> && batch_view<ViewOut, D + 1, Complex>
+    static auto dft(ViewIn in, ViewOut out, Direction direction, Flags flags, int threads = 1)
+        -> basic_batched_plan;
+
+    template <typename BufferIn, typename BufferOut>
+        requires appropriate_buffers<1u, Real, Complex, BufferIn, BufferOut>
+    static auto dft(std::array<int, D> n, int howmany, BufferIn &in, batch_stride in_layout,
+                    BufferOut &out, batch_stride out_layout, Direction direction, Flags flags,
+                    int threads = 1) -> basic_batched_plan;
+};
+
+/// Batched r2c transforms, see basic_batched_plan.
+/// The complex batch holds the n/2+1 half-spectrum along the last (row-major) transform dimension.
+template <size_t D, class Real, class Complex = std::complex<Real>>
+class basic_batched_plan_r2c : public plan_base<D, Real, Complex> {
+  private:
+    using base = plan_base<D, Real, Complex>;
+    using plan_t = typename base::plan_t;
+
+  public:
+    using real_t = Real;
+    using complex_t = Complex;
+
+    using base::c_plan;
+    using base::plan_base;
+
+    /// Executes the plan with the buffers provided initially.
+    void operator()() const;
+
+    template <typename ViewIn, typename ViewOut>
+        requires batch_view<ViewIn, D + 1, Real> && batch_view<ViewOut, D + 1, Complex>
+    void operator()(ViewIn in, ViewOut out) const;
+
+    template <typename BufferIn, typename BufferOut>
+        requires detail::buffer_like<BufferIn> && detail::buffer_like<BufferOut>
+    void operator()(BufferIn &in, BufferOut &out) const;
+
+    /// \defgroup{planning utilities}
+    template <typename ViewIn, typename ViewOut>
+        requires batch_view<ViewIn, D + 1, Real> && batch_view<ViewOut, D + 1, Complex>
+    static auto dft(ViewIn in, ViewOut out, Flags flags, int threads = 1)
+        -> basic_batched_plan_r2c;
+
+    /// `n` are the real extents, the complex transforms have extents n/2+1 in the last dimension.
+    template <typename BufferIn, typename BufferOut>
+        requires detail::buffer_like<BufferIn> && detail::buffer_like<BufferOut>
+    static auto dft(std::array<int, D> n, int howmany, BufferIn &in, batch_stride in_layout,
+                    BufferOut &out, batch_stride out_layout, Flags flags, int threads = 1)
+        -> basic_batched_plan_r2c;
+};
+
+/// Batched c2r transforms, see basic_batched_plan_r2c.
+template <size_t D, class Real, class Complex = std::complex<Real>>
+class basic_batched_plan_c2r : public plan_base<D, Real, Complex> {
+  private:
+    using base = plan_base<D, Real, Complex>;
+    using plan_t = typename base::plan_t;
+
+  public:
+    using real_t = Real;
+    using complex_t = Complex;
+
+    using base::c_plan;
+    using base::plan_base;
+
+    /// Executes the plan with the buffers provided initially.
+    void operator()() const;
+
+    template <typename ViewIn, typename ViewOut>
+        requires batch_view<ViewIn, D + 1, Complex> && batch_view<ViewOut, D + 1, Real>
+    void operator()(ViewIn in, ViewOut out) const;
+
+    template <typename BufferIn, typename BufferOut>
+        requires detail::buffer_like<BufferIn> && detail::buffer_like<BufferOut>
+    void operator()(BufferIn &in, BufferOut &out) const;
+
+    /// \defgroup{planning utilities}
+    template <typename ViewIn, typename ViewOut>
+        requires batch_view<ViewIn, D + 1, Complex> && batch_view<ViewOut, D + 1, Real>
+    static auto dft(ViewIn in, ViewOut out, Flags flags, int threads = 1)
+        -> basic_batched_plan_c2r;
+
+    /// `n` are the real extents, the complex transforms have extents n/2+1 in the last dimension.
+    template <typename BufferIn, typename BufferOut>
+        requires detail::buffer_like<BufferIn> && detail::buffer_like<BufferOut>
+    static auto dft(std::array<int, D> n, int howmany, BufferIn &in, batch_stride in_layout,
+                    BufferOut &out, batch_stride out_layout, Flags flags, int threads = 1)
+        -> basic_batched_plan_c2r;
+};
+
+// =================
+// basic_batched_plan
+// =================
+
+template <size_t D, class Real, class Complex>
+void basic_batched_plan<D, Real, Complex>::operator()() const {
+    auto timer = this->time_execution();
+    detail::fftw_types<Real>::execute(c_plan());
+}
+
+template <size_t D, class Real, class Complex>
+template <typename ViewIn, typename ViewOut>
+    requires batch_view<ViewIn, D + 1, Complex> && batch_view<ViewOut, D + 1, Complex>
+void basic_batched_plan<D, Real, Complex>::operator()(ViewIn in, ViewOut out) const {
+    auto timer = this->time_execution();
+    auto *in_ptr = detail::unwrap<false, Real, Complex>(in);
+    auto *out_ptr = detail::unwrap<false, Real, Complex>(out);
+    detail::fftw_types<Real>::execute_dft(this->plan_for(in_ptr, out_ptr), in_ptr, out_ptr);
+}
+
+template <size_t D, class Real, class Complex>
+template <typename BufferIn, typename BufferOut>
+    requires appropriate_buffers<1u, Real, Complex, BufferIn, BufferOut>
+void basic_batched_plan<D, Real, Complex>::operator()(BufferIn &in, BufferOut &out) const {
+    auto timer = this->time_execution();
+    auto *in_ptr = detail::unwrap<false, Real, Complex>(in);
+    auto *out_ptr = detail::unwrap<false, Real, Complex>(out);
+    detail::fftw_types<Real>::execute_dft(this->plan_for(in_ptr, out_ptr), in_ptr, out_ptr);
+}
+
+template <size_t D, class Real, class Complex>
+template <typename ViewIn, typename ViewOut>
+    requires batch_view<ViewIn, D + 1, Complex> && batch_view<ViewOut, D + 1, Complex>
+auto basic_batched_plan<D, Real, Complex>::dft(ViewIn in, ViewOut out, Direction direction,
+                                               Flags flags, int threads) -> basic_batched_plan {
+    if (direction != FORWARD and direction != BACKWARD) {
+        throw std::invalid_argument("invalid direction");
+    }
+    auto Planner = [direction, threads](auto &in, auto &out, Flags flags) {
+        auto [in_dims, out_dims] = detail::dims_many<D>(in, out);
+        detail::plan_with_threads<Real>(threads);
+        return detail::fftw_types<Real>::plan_many_dft(
+            D, in_dims.n.data(), in_dims.howmany, detail::unwrap<false, Real, Complex>(in), nullptr,
+            1, in_dims.dist, detail::unwrap<false, Real, Complex>(out), nullptr, 1, out_dims.dist,
+            direction, flags);
+    };
+
+    std::lock_guard lock{detail::planner_mutex()};
+    basic_batched_plan plan{detail::require_plan(Planner(in, out, flags))};
+    plan.enable_fallback(in, out, flags, Planner);
+    return plan;
+}
+
+template <size_t D, class Real, class Complex>
+template <typename BufferIn, typename BufferOut>
+    requires appropriate_buffers<1u, Real, Complex, BufferIn, BufferOut>
+auto basic_batched_plan<D, Real, Complex>::dft(std::array<int, D> n, int howmany, BufferIn &in,
+                                               batch_stride in_layout, BufferOut &out,
+                                               batch_stride out_layout, Direction direction,
+                                               Flags flags, int threads) -> basic_batched_plan {
+    if (direction != FORWARD and direction != BACKWARD) {
+        throw std::invalid_argument("invalid direction");
+    }
+    detail::validate_batch_span<D>(in.size(), n, howmany, in_layout);
+    detail::validate_batch_span<D>(out.size(), n, howmany, out_layout);
+
+    auto Planner = [=](auto &in, auto &out, Flags flags) mutable {
+        detail::plan_with_threads<Real>(threads);
+        return detail::fftw_types<Real>::plan_many_dft(
+            D, n.data(), howmany, detail::unwrap<false, Real, Complex>(in), nullptr,
+            in_layout.stride, in_layout.dist, detail::unwrap<false, Real, Complex>(out), nullptr,
+            out_layout.stride, out_layout.dist, direction, flags);
+    };
+
+    std::lock_guard lock{detail::planner_mutex()};
+    basic_batched_plan plan{detail::require_plan(Planner(in, out, flags))};
+    plan.enable_fallback(in, out, flags, Planner);
+    return plan;
+}
+
+// =================
+// basic_batched_plan_r2c
+// =================
+
+template <size_t D, class Real, class Complex>
+void basic_batched_plan_r2c<D, Real, Complex>::operator()() const {
+    auto timer = this->time_execution();
+    detail::fftw_types<Real>::execute(c_plan());
+}
+
+template <size_t D, class Real, class Complex>
+template <typename ViewIn, typename ViewOut>
+    requires batch_view<ViewIn, D + 1, Real> && batch_view<ViewOut, D + 1, Complex>
+void basic_batched_plan_r2c<D, Real, Complex>::operator()(ViewIn in, ViewOut out) const {
+    auto timer = this->time_execution();
+    auto *in_ptr = detail::unwrap<true, Real, Complex>(in);
+    auto *out_ptr = detail::unwrap<false, Real, Complex>(out);
+    detail::fftw_types<Real>::execute_dft_r2c(this->plan_for(in_ptr, out_ptr), in_ptr, out_ptr);
+}
+
+template <size_t D, class Real, class Complex>
+template <typename BufferIn, typename BufferOut>
+    requires detail::buffer_like<BufferIn> && detail::buffer_like<BufferOut>
+void basic_batched_plan_r2c<D, Real, Complex>::operator()(BufferIn &in, BufferOut &out) const {
+    auto timer = this->time_execution();
+    auto *in_ptr = detail::unwrap<true, Real, Complex>(in);
+    auto *out_ptr = detail::unwrap<false, Real, Complex>(out);
+    detail::fftw_types<Real>::execute_dft_r2c(this->plan_for(in_ptr, out_ptr), in_ptr, out_ptr);
+}
+
+template <size_t D, class Real, class Complex>
+template <typename ViewIn, typename ViewOut>
+    requires batch_view<ViewIn, D + 1, Real> && batch_view<ViewOut, D + 1, Complex>
+auto basic_batched_plan_r2c<D, Real, Complex>::dft(ViewIn in, ViewOut out, Flags flags,
+                                                   int threads) -> basic_batched_plan_r2c {
+    // embeddings are passed explicitly, so FFTW never assumes the padded in-place layout
+    auto Planner = [threads](auto &in, auto &out, Flags flags) {
+        auto [r_dims, c_dims] = detail::dims_many_r2c<D>(in, out);
+        detail::plan_with_threads<Real>(threads);
+        return detail::fftw_types<Real>::plan_many_dft_r2c(
+            D, r_dims.n.data(), r_dims.howmany, detail::unwrap<true, Real, Complex>(in),
+            r_dims.n.data(), 1, r_dims.dist, detail::unwrap<false, Real, Complex>(out),
+            c_dims.n.data(), 1, c_dims.dist, flags);
+    };
+
+    std::lock_guard lock{detail::planner_mutex()};
+    basic_batched_plan_r2c plan{detail::require_plan(Planner(in, out, flags))};
+    plan.enable_fallback(in, out, flags, Planner);
+    return plan;
+}
+
+template <size_t D, class Real, class Complex>
+template <typename BufferIn, typename BufferOut>
+    requires detail::buffer_like<BufferIn> && detail::buffer_like<BufferOut>
+auto basic_batched_plan_r2c<D, Real, Complex>::dft(std::array<int, D> n, int howmany,
+                                                   BufferIn &in, batch_stride in_layout,
+                                                   BufferOut &out, batch_stride out_layout,
+                                                   Flags flags, int threads)
+    -> basic_batched_plan_r2c {
+    auto n_complex = detail::half_spectrum(n);
+    detail::validate_batch_span<D>(in.size(), n, howmany, in_layout);
+    detail::validate_batch_span<D>(out.size(), n_complex, howmany, out_layout);
+
+    auto Planner = [=](auto &in, auto &out, Flags flags) mutable {
+        detail::plan_with_threads<Real>(threads);
+        return detail::fftw_types<Real>::plan_many_dft_r2c(
+            D, n.data(), howmany, detail::unwrap<true, Real, Complex>(in), n.data(),
+            in_layout.stride, in_layout.dist, detail::unwrap<false, Real, Complex>(out),
+            n_complex.data(), out_layout.stride, out_layout.dist, flags);
+    };
+
+    std::lock_guard lock{detail::planner_mutex()};
+    basic_batched_plan_r2c plan{detail::require_plan(Planner(in, out, flags))};
+    plan.enable_fallback(in, out, flags, Planner);
+    return plan;
+}
+
+// =================
+// basic_batched_plan_c2r
+// =================
+
+template <size_t D, class Real, class Complex>
+void basic_batched_plan_c2r<D, Real, Complex>::operator()() const {
+    auto timer = this->time_execution();
+    detail::fftw_types<Real>::execute(c_plan());
+}
+
+template <size_t D, class Real, class Complex>
+template <typename ViewIn, typename ViewOut>
+    requires batch_view<ViewIn, D + 1, Complex> && batch_view<ViewOut, D + 1, Real>
+void basic_batched_plan_c2r<D, Real, Complex>::operator()(ViewIn in, ViewOut out) const {
+    auto timer = this->time_execution();
+    auto *in_ptr = detail::unwrap<false, Real, Complex>(in);
+    auto *out_ptr = detail::unwrap<true, Real, Complex>(out);
+    detail::fftw_types<Real>::execute_dft_c2r(this->plan_for(in_ptr, out_ptr), in_ptr, out_ptr);
+}
+
+template <size_t D, class Real, class Complex>
+template <typename BufferIn, typename BufferOut>
+    requires detail::buffer_like<BufferIn> && detail::buffer_like<BufferOut>
+void basic_batched_plan_c2r<D, Real, Complex>::operator()(BufferIn &in, BufferOut &out) const {
+    auto timer = this->time_execution();
+    auto *in_ptr = detail::unwrap<false, Real, Complex>(in);
+    auto *out_ptr = detail::unwrap<true, Real, Complex>(out);
+    detail::fftw_types<Real>::execute_dft_c2r(this->plan_for(in_ptr, out_ptr), in_ptr, out_ptr);
+}
+
+template <size_t D, class Real, class Complex>
+template <typename ViewIn, typename ViewOut>
+    requires batch_view<ViewIn, D + 1, Complex> && batch_view<ViewOut, D + 1, Real>
+auto basic_batched_plan_c2r<D, Real, Complex>::dft(ViewIn in, ViewOut out, Flags flags,
+                                                   int threads) -> basic_batched_plan_c2r {
+    auto Planner = [threads](auto &in, auto &out, Flags flags) {
+        auto [r_dims, c_dims] = detail::dims_many_r2c<D>(out, in);
+        detail::plan_with_threads<Real>(threads);
+        return detail::fftw_types<Real>::plan_many_dft_c2r(
+            D, r_dims.n.data(), r_dims.howmany, detail::unwrap<false, Real, Complex>(in),
+            c_dims.n.data(), 1, c_dims.dist, detail::unwrap<true, Real, Complex>(out),
+            r_dims.n.data(), 1, r_dims.dist, flags);
+    };
+
+    std::lock_guard lock{detail::planner_mutex()};
+    basic_batched_plan_c2r plan{detail::require_plan(Planner(in, out, flags))};
+    plan.enable_fallback(in, out, flags, Planner);
+    return plan;
+}
+
+template <size_t D, class Real, class Complex>
+template <typename BufferIn, typename BufferOut>
+    requires detail::buffer_like<BufferIn> && detail::buffer_like<BufferOut>
+auto basic_batched_plan_c2r<D, Real, Complex>::dft(std::array<int, D> n, int howmany,
+                                                   BufferIn &in, batch_stride in_layout,
+                                                   BufferOut &out, batch_stride out_layout,
+                                                   Flags flags, int threads)
+    -> basic_batched_plan_c2r {
+    auto n_complex = detail::half_spectrum(n);
+    detail::validate_batch_span<D>(in.size(), n_complex, howmany, in_layout);
+    detail::validate_batch_span<D>(out.size(), n, howmany, out_layout);
+
+    auto Planner = [=](auto &in, auto &out, Flags flags) mutable {
+        detail::plan_with_threads<Real>(threads);
+        return detail::fftw_types<Real>::plan_many_dft_c2r(
+            D, n.data(), howmany, detail::unwrap<false, Real, Complex>(in), n_complex.data(),
+            in_layout.stride, in_layout.dist, detail::unwrap<true, Real, Complex>(out), n.data(),
+            out_layout.stride, out_layout.dist, flags);
+    };
+
+    std::lock_guard lock{detail::planner_mutex()};
+    basic_batched_plan_c2r plan{detail::require_plan(Planner(in, out, flags))};
+    plan.enable_fallback(in, out, flags, Planner);
+    return plan;
+}
+
+} // namespace fftw
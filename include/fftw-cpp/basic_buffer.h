@@ -1,28 +1,53 @@
 #pragma once
 
 #include <memory>
+#include <new>
+#include <ranges>
+#include <type_traits>
 
 namespace fftw {
 
-template <class Real, class Complex = std::complex<Real>, bool IsReal = false> class basic_buffer;
+/// The default storage policy of buffers: fftw_malloc and fftw_free of the matching precision.
+/// A storage policy provides static allocate(bytes) and deallocate(ptr, bytes); the memory must
+/// be aligned at least like fftw_malloc's, so that plans stay on the aligned SIMD path.
+template <std::floating_point Real> struct fftw_allocator {
+    static void *allocate(size_t bytes) { return detail::fftw_types<Real>::malloc(bytes); }
+    static void deallocate(void *ptr, size_t) noexcept { detail::fftw_types<Real>::free(ptr); }
+};
 
-template <class Real, class Complex = std::complex<Real>>
-using basic_rbuffer = basic_buffer<Real, Complex, true>;
+template <class Real, class Complex = std::complex<Real>, bool IsReal = false,
+          class Storage = fftw_allocator<Real>>
+class basic_buffer;
+
+template <class Real, class Complex = std::complex<Real>, class Storage = fftw_allocator<Real>>
+using basic_rbuffer = basic_buffer<Real, Complex, true, Storage>;
 
 template <typename Real, typename Extents, typename Complex = std::complex<Real>,
-          typename Layout = MDSPAN::layout_right, bool IsReal = false>
+          typename Layout = MDSPAN::layout_right, bool IsReal = false,
+          class Storage = fftw_allocator<Real>>
 using basic_mdbuffer = MDSPAN::mdarray<std::conditional_t<IsReal, Real, Complex>, Extents, Layout,
-                                       fftw::basic_buffer<Real, Complex, IsReal>>;
+                                       fftw::basic_buffer<Real, Complex, IsReal, Storage>>;
 
 template <typename Real, typename Extents, typename Complex = std::complex<Real>,
-          typename Layout = MDSPAN::layout_right>
-using basic_rmdbuffer = basic_mdbuffer<Real, Extents, Complex, Layout, true>;
+          typename Layout = MDSPAN::layout_right, class Storage = fftw_allocator<Real>>
+using basic_rmdbuffer = basic_mdbuffer<Real, Extents, Complex, Layout, true, Storage>;
+
+namespace detail {
+/// Returns the memory of a buffer to its storage policy, which may need the size (e.g. a pool).
+template <class Storage> struct storage_deleter {
+    size_t bytes{0};
+    void operator()(void *ptr) const noexcept {
+        if (ptr != nullptr) { Storage::deallocate(ptr, bytes); }
+    }
+};
+} // namespace detail
 
 template <bool IsReal, class Real, class Complex = std::complex<double>>
 using underlying_element_type = std::conditional_t<IsReal, Real, detail::fftw_complex_t<Real>>;
 
-template <class Real, class Complex, bool IsReal> class basic_buffer {
+template <class Real, class Complex, bool IsReal, class Storage> class basic_buffer {
   public:
+    using storage_type = Storage;
     using element_type = std::conditional_t<IsReal, Real, Complex>;
     using value_type = element_type; ///< for STL-compatibility, TODO remove element_type
     using pointer = element_type *;
@@ -58,32 +83,88 @@ template <class Real, class Complex, bool IsReal> class basic_buffer {
 
   private:
     size_t length{0};
-    std::unique_ptr<underlying_element_type[], decltype(&fftw_free)> storage;
+    std::unique_ptr<underlying_element_type[], detail::storage_deleter<Storage>> storage;
 };
 
-template <class Real, class Complex, bool IsReal>
-basic_buffer<Real, Complex, IsReal>::basic_buffer(std::size_t length)
-    : length(length), storage(nullptr, &fftw_free) {
-    storage = {reinterpret_cast<underlying_element_type *>(
-                   fftw_malloc(length * sizeof(underlying_element_type))),
-               &fftw_free};
+template <class Real, class Complex, bool IsReal, class Storage>
+basic_buffer<Real, Complex, IsReal, Storage>::basic_buffer(std::size_t length)
+    : length(length), storage(nullptr, {length * sizeof(underlying_element_type)}) {
+    auto bytes = length * sizeof(underlying_element_type);
+    storage = {reinterpret_cast<underlying_element_type *>(Storage::allocate(bytes)),
+               detail::storage_deleter<Storage>{bytes}};
+    if (!storage && length != 0) { throw std::bad_alloc(); }
 }
 
-template <class Real, class Complex, bool IsReal>
-basic_buffer<Real, Complex, IsReal>::basic_buffer(size_t length, element_type value)
+template <class Real, class Complex, bool IsReal, class Storage>
+basic_buffer<Real, Complex, IsReal, Storage>::basic_buffer(size_t length, element_type value)
     : basic_buffer(length) {
-    for (Complex &elem : *this) {
+    for (element_type &elem : *this) {
         elem = value;
     }
 }
 } // namespace fftw
 
-template <class Real, class Complex, bool IsReal>
-auto fftw::basic_buffer<Real, Complex, IsReal>::data() -> element_type * {
+template <class Real, class Complex, bool IsReal, class Storage>
+auto fftw::basic_buffer<Real, Complex, IsReal, Storage>::data() -> element_type * {
     return reinterpret_cast<element_type *>(storage.get());
 }
 
-template <class Real, class Complex, bool IsReal>
-auto fftw::basic_buffer<Real, Complex, IsReal>::data() const -> const element_type * {
+template <class Real, class Complex, bool IsReal, class Storage>
+auto fftw::basic_buffer<Real, Complex, IsReal, Storage>::data() const -> const element_type * {
     return reinterpret_cast<const element_type *>(storage.get());
-}
\ No newline at end of file
+}
+namespace fftw {
+
+/// A non-owning buffer over memory the caller owns, e.g. a std::vector, a std::span or a ring in
+/// shared memory, so it can be transformed without copying into a basic_buffer.
+/// Unlike basic_buffer, the memory may not be SIMD-aligned: alignment() reports its alignment
+/// class, and plans executed on such memory fall back to an FFTW_UNALIGNED plan when needed.
+template <class Real, class Complex = std::complex<Real>, bool IsReal = false>
+class basic_buffer_view {
+  public:
+    using element_type = std::conditional_t<IsReal, Real, Complex>;
+    using value_type = element_type;
+    using pointer = element_type *;
+    using reference = element_type &;
+
+    using underlying_element_type = std::conditional_t<IsReal, Real, detail::fftw_complex_t<Real>>;
+
+    basic_buffer_view(element_type *data, size_t length) : ptr(data), length(length) {}
+
+    /// Views any contiguous range of elements, including a basic_buffer.
+    template <std::ranges::contiguous_range Range>
+        requires std::ranges::sized_range<Range> &&
+                 std::same_as<std::ranges::range_value_t<Range>, element_type> &&
+                 (!std::same_as<std::remove_cvref_t<Range>, basic_buffer_view>)
+    basic_buffer_view(Range &range)
+        : basic_buffer_view(std::ranges::data(range), std::ranges::size(range)) {}
+
+    /// \defgroup Container methods (for range-for and other stdlib compatibility)
+    /// @{
+    element_type *data() const { return ptr; }                          ///<
+    element_type *begin() const { return ptr; }                         ///<
+    element_type *end() const { return ptr + length; }                  ///<
+    [[nodiscard]] size_t size() const { return length; }                ///<
+    element_type &operator[](size_t index) const { return ptr[index]; } ///<
+    /// @}
+
+    [[nodiscard]] underlying_element_type *unwrap() const {
+        return reinterpret_cast<underlying_element_type *>(ptr);
+    }
+
+    /// The alignment class of the memory, as returned by fftw_alignment_of; 0 is SIMD-aligned.
+    [[nodiscard]] int alignment() const {
+        return detail::fftw_types<Real>::alignment_of(reinterpret_cast<Real *>(ptr));
+    }
+
+    [[nodiscard]] bool is_simd_aligned() const { return alignment() == 0; }
+
+  private:
+    element_type *ptr;
+    size_t length;
+};
+
+template <class Real, class Complex = std::complex<Real>>
+using basic_rbuffer_view = basic_buffer_view<Real, Complex, true>;
+
+} // namespace fftw
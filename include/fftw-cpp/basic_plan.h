@@ -1,48 +1,345 @@
 #pragma once
 
 #include "basic_buffer.h"
+#include "instrumentation.h"
+#include "layout_r2c_padded.h"
 #include "util.h"
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace fftw {
 
+namespace detail {
+/// A view of the same shape as a buffer or view, whose memory can be swapped with rebind().
+/// Used to plan the same transform again on other arrays.
+template <class Real, class Complex, bool IsReal, class Storage>
+auto rebindable(basic_buffer<Real, Complex, IsReal, Storage> &buf) {
+    return basic_buffer_view<Real, Complex, IsReal>{buf.data(), buf.size()};
+}
+
+template <class Real, class Complex, bool IsReal>
+auto rebindable(basic_buffer_view<Real, Complex, IsReal> view) {
+    return view;
+}
+
+template <mdspan_like View> auto rebindable(View view) { return view; }
+
+template <mdarray_like MdBuffer> auto rebindable(MdBuffer &buf) { return buf.to_mdspan(); }
+
+template <class Real, class Complex, bool IsReal>
+auto rebind(basic_buffer_view<Real, Complex, IsReal> view, void *ptr) {
+    using element_type = typename basic_buffer_view<Real, Complex, IsReal>::element_type;
+    return basic_buffer_view<Real, Complex, IsReal>{static_cast<element_type *>(ptr), view.size()};
+}
+
+template <class Real, class Complex, bool IsReal>
+auto *data_of(const basic_buffer_view<Real, Complex, IsReal> &view) {
+    return view.data();
+}
+
+template <mdspan_like View> auto *data_of(const View &view) { return view.data_handle(); }
+
+template <mdspan_like View> View rebind(const View &view, void *ptr) {
+    return View{static_cast<typename View::data_handle_type>(ptr), view.mapping()};
+}
+
+/// Multiplies count contiguous reals by factor; a plain loop the compiler vectorizes.
+template <class Real> void scale_reals(Real *data, size_t count, Real factor) {
+    for (size_t i = 0; i < count; ++i) {
+        data[i] *= factor;
+    }
+}
+
+/// Multiplies every element of a buffer or view by factor, in a single pass over its memory.
+/// Views without gaps are scaled as one flat array of reals, and so is the padding of
+/// layout_r2c_padded, which holds no data. Other strided views are scaled element by element,
+/// so memory between their elements is left alone.
+template <class Real, typename View> void scale(View &&view, Real factor) {
+    using T = std::remove_cvref_t<View>;
+    if constexpr (mdarray_like<T>) {
+        scale(view.to_mdspan(), factor);
+    } else if constexpr (mdspan_like<T>) {
+        constexpr size_t reals = sizeof(typename T::element_type) / sizeof(Real);
+        auto *data = reinterpret_cast<Real *>(view.data_handle());
+        const auto &mapping = view.mapping();
+        if (std::same_as<typename T::layout_type, layout_r2c_padded> || mapping.is_exhaustive()) {
+            scale_reals(data, size_t(mapping.required_span_size()) * reals, factor);
+            return;
+        }
+
+        constexpr size_t R = T::rank();
+        if (view.size() == 0) { return; }
+        std::array<size_t, R> idx{};
+        for (size_t i = 0; i < size_t(view.size()); ++i) {
+            size_t offset = 0;
+            for (size_t r = 0; r < R; ++r) {
+                offset += idx[r] * size_t(mapping.stride(r));
+            }
+            scale_reals(data + offset * reals, reals, factor);
+            for (size_t r = R; r-- > 0;) {
+                if (++idx[r] < view.extent(r)) { break; }
+                idx[r] = 0;
+            }
+        }
+    } else {
+        using element_type = typename T::element_type;
+        scale_reals(reinterpret_cast<Real *>(view.data()),
+                    view.size() * (sizeof(element_type) / sizeof(Real)), factor);
+    }
+}
+
+/// Returns a plan FFTW created, or throws if it returned none, e.g. for WISDOM_ONLY without
+/// wisdom for the transform.
+template <typename Plan> Plan require_plan(Plan p) {
+    if (p == nullptr) { throw std::runtime_error("failed to create plan"); }
+    return p;
+}
+
+} // namespace detail
+
+/// Operation counts of a plan, as reported by fftw_flops.
+struct plan_flops {
+    double add{0.0};
+    double mul{0.0};
+    double fma{0.0};
+
+    /// Total floating-point operations, counting a fused multiply-add as two.
+    [[nodiscard]] double total() const { return add + mul + 2.0 * fma; }
+};
+
 template <size_t D, class Real, class Complex> class plan_base {
   protected:
     using plan_t = detail::fftw_plan_t<Real>;
-    std::unique_ptr<std::remove_pointer_t<plan_t>, decltype(&fftw_destroy_plan)> plan;
+    using plan_ptr =
+        std::unique_ptr<std::remove_pointer_t<plan_t>, decltype(&detail::destroy_plan<Real>)>;
+    plan_ptr plan;
 
   public:
-    plan_base() noexcept : plan(nullptr, &fftw_destroy_plan) {}
+    plan_base() noexcept : plan(nullptr, &detail::destroy_plan<Real>) {}
 
-    explicit plan_base(plan_t ptr) noexcept : plan(ptr, &fftw_destroy_plan) {}
+    explicit plan_base(plan_t ptr) noexcept : plan(ptr, &detail::destroy_plan<Real>) {}
 
     /// Returns the underlying FFTW plan.
     plan_t c_plan() const { return plan.get(); }
+
+    /// \defgroup{introspection}
+    /// Operation counts of one execution.
+    [[nodiscard]] plan_flops flops() const {
+        plan_flops result;
+        std::lock_guard lock{detail::planner_mutex()};
+        detail::fftw_types<Real>::flops(checked_plan(), &result.add, &result.mul, &result.fma);
+        return result;
+    }
+
+    /// The cost the planner measured for this plan, 0 if it did not measure (ESTIMATE).
+    [[nodiscard]] double cost() const {
+        std::lock_guard lock{detail::planner_mutex()};
+        return detail::fftw_types<Real>::cost(checked_plan());
+    }
+
+    /// The planner's estimate of the cost, in arbitrary units comparable between plans.
+    [[nodiscard]] double estimate_cost() const {
+        std::lock_guard lock{detail::planner_mutex()};
+        return detail::fftw_types<Real>::estimate_cost(checked_plan());
+    }
+
+    /// The algorithm the planner chose, in FFTW's plan notation (fftw_sprint_plan).
+    [[nodiscard]] std::string to_string() const {
+        std::lock_guard lock{detail::planner_mutex()};
+        std::unique_ptr<char, decltype(&std::free)> str{
+            detail::fftw_types<Real>::sprint_plan(checked_plan()), &std::free};
+        return str ? std::string{str.get()} : std::string{};
+    }
+
+    /// Starts recording call counts, latencies and achieved GFLOP/s of every execution under
+    /// `name`, see instrumentation_snapshot() and write_instrumentation_json(). Executions that
+    /// are not instrumented only test a null pointer. Call this before executing the plan from
+    /// other threads.
+    void instrument(std::string name) {
+        metrics = std::make_shared<detail::plan_metrics>(std::move(name), to_string(),
+                                                         flops().total());
+        detail::metrics_registry::instance().add(metrics);
+    }
+
+    /// The metrics recorded since instrument(), empty if the plan is not instrumented.
+    [[nodiscard]] execution_stats stats() const {
+        return metrics ? metrics->snapshot() : execution_stats{};
+    }
+
+    /// Whether new-array execution on these arrays uses the plan itself. FFTW requires the arrays
+    /// to have the alignment class of the ones the plan was created on (unless it was created
+    /// with UNALIGNED); otherwise, an UNALIGNED fallback plan is created and used instead.
+    [[nodiscard]] bool is_aligned_for(const void *in, const void *out) const {
+        return !fallback || (detail::alignment_of<Real>(in) == fallback->in_alignment &&
+                             detail::alignment_of<Real>(out) == fallback->out_alignment);
+    }
+
+  protected:
+    /// \defgroup{normalization}
+    /// Scales the output of every execution according to mode, e.g. BACKWARD makes a backward
+    /// plan compute the inverse of the forward transform. The scaling is a separate, vectorized
+    /// pass over the whole output after the transform: for arrays larger than the cache, one more
+    /// read and write of the output. FFTW cannot scale inside a plan, and splitting a plan into
+    /// passes that scale each slab after the last one would replace FFTW's own decomposition of
+    /// the transform, so the pass is not fused. Not thread-safe with respect to concurrent
+    /// executions.
+    void normalize(normalization mode) {
+        if (!scale_planned) { throw std::logic_error("plan does not support normalization"); }
+        long double factor = 1.0L;
+        auto n = static_cast<long double>(normalized_size);
+        switch (mode) {
+        case normalization::NONE:
+            break;
+        case normalization::BACKWARD:
+            factor = normalized_direction == BACKWARD ? 1.0L / n : 1.0L;
+            break;
+        case normalization::FORWARD:
+            factor = normalized_direction == FORWARD ? 1.0L / n : 1.0L;
+            break;
+        case normalization::ORTHO:
+            factor = 1.0L / std::sqrt(n);
+            break;
+        }
+        output_scale = Real(factor);
+    }
+
+    /// The factor every output element is multiplied by, 1 without normalization.
+    [[nodiscard]] Real scale_factor() const { return output_scale; }
+
+    /// Records what normalize() needs: the logical size of one transform, its direction, and the
+    /// output the plan was created on, which operator()() scales.
+    template <typename Out> void enable_normalization(Out &out, size_t n, Direction direction) {
+        normalized_size = n;
+        normalized_direction = direction;
+        scale_planned = [view = detail::rebindable(out)](Real factor) mutable {
+            detail::scale<Real>(view, factor);
+        };
+    }
+
+    /// Applies the normalization to the output of an execution.
+    template <typename Out> void scale_output(Out &&out) const {
+        if (output_scale != Real(1)) { detail::scale<Real>(std::forward<Out>(out), output_scale); }
+    }
+
+    /// Applies the normalization to the output the plan was created on.
+    void scale_planned_output() const {
+        if (output_scale != Real(1)) { scale_planned(output_scale); }
+    }
+
+    using planner_t = std::function<plan_t(void *in, void *out, Flags flags)>;
+
+    /// Records the duration of the current execution if the plan is instrumented.
+    [[nodiscard]] detail::execution_timer time_execution() const {
+        return detail::execution_timer{metrics.get()};
+    }
+
+    /// Remembers how to plan this transform on other arrays, for new-array execution on arrays
+    /// of another alignment class. `planner(in, out, flags)` receives rebindable() views of the
+    /// original arguments, pointing to the new arrays.
+    template <typename In, typename Out, typename Planner>
+    void enable_fallback(In &in, Out &out, Flags flags, Planner planner) {
+        if ((unsigned(flags) & FFTW_UNALIGNED) != 0) { return; }
+        auto in_proto = detail::rebindable(in);
+        auto out_proto = detail::rebindable(out);
+        fallback = std::make_unique<fallback_state>(
+            [=](void *new_in, void *new_out, Flags f) mutable {
+                auto in_view = detail::rebind(in_proto, new_in);
+                auto out_view = detail::rebind(out_proto, new_out);
+                return planner(in_view, out_view, f);
+            },
+            flags, detail::alignment_of<Real>(detail::data_of(in_proto)),
+            detail::alignment_of<Real>(detail::data_of(out_proto)));
+    }
+
+    /// The plan to execute on these arrays: the plan itself if the alignment matches,
+    /// the UNALIGNED fallback (created on first use) otherwise.
+    plan_t plan_for(void *in, void *out) const {
+        if (is_aligned_for(in, out)) { return c_plan(); }
+
+        std::lock_guard fallback_lock{fallback->mutex};
+        if (!fallback->plan) {
+            // Neither WISDOM_ONLY nor ESTIMATE touch the arrays, which hold the user's data.
+            std::lock_guard lock{detail::planner_mutex()};
+            auto rigor = Flags(unsigned(fallback->flags) & ~unsigned(FFTW_UNALIGNED));
+            auto p = fallback->planner(in, out, rigor | UNALIGNED | WISDOM_ONLY);
+            if (p == nullptr) { p = fallback->planner(in, out, ESTIMATE | UNALIGNED); }
+            if (p == nullptr) { throw std::runtime_error("failed to create an unaligned plan"); }
+            fallback->plan = plan_ptr{p, &detail::destroy_plan<Real>};
+        }
+        return fallback->plan.get();
+    }
+
+  private:
+    plan_t checked_plan() const {
+        if (!plan) { throw std::logic_error("empty plan"); }
+        return plan.get();
+    }
+
+    struct fallback_state {
+        fallback_state(planner_t planner, Flags flags, int in_alignment, int out_alignment)
+            : planner(std::move(planner)), flags(flags), in_alignment(in_alignment),
+              out_alignment(out_alignment) {}
+
+        planner_t planner;
+        Flags flags;
+        int in_alignment;
+        int out_alignment;
+        std::mutex mutex;
+        plan_ptr plan{nullptr, &detail::destroy_plan<Real>};
+    };
+
+    std::unique_ptr<fallback_state> fallback;
+    std::shared_ptr<detail::plan_metrics> metrics;
+
+    size_t normalized_size{1};
+    Direction normalized_direction{FORWARD};
+    Real output_scale{1};
+    std::function<void(Real)> scale_planned;
 };
 
 /// This concept checks that the layout is appropriate for this type of plan.
-/// By default, it is false
+/// layout_right and layout_left are planned with the basic interface, while layout_stride
+/// (e.g. a column or a sub-block of a larger array) is described to FFTW by its strides through
+/// the guru64 interface, so no staging copies are needed.
 template <typename Layout>
-concept appropriate_layout = std::same_as<MDSPAN::layout_right, Layout>;
-// TODO support for other layouts
+concept appropriate_layout =
+    std::same_as<MDSPAN::layout_right, Layout> || std::same_as<MDSPAN::layout_left, Layout> ||
+    std::same_as<MDSPAN::layout_stride, Layout>;
 
 /// This boolean checks that the buffer is appropriate for this type of plan.
 /// By default, it is false
 template <size_t D, class Real, class Complex, typename T>
 constexpr inline bool appropriate_buffer = false;
 
-// We allow basic_buffer for 1D transforms
+// We allow basic_buffer for 1D transforms, with any storage policy
+template <class Real, class Complex, class Storage>
+constexpr inline bool
+    appropriate_buffer<1u, Real, Complex, basic_buffer<Real, Complex, false, Storage>> = true;
+
+// We allow non-owning views of user memory for 1D transforms
 template <class Real, class Complex>
-constexpr inline bool appropriate_buffer<1u, Real, Complex, basic_buffer<Real, Complex>> = true;
+constexpr inline bool
+    appropriate_buffer<1u, Real, Complex, basic_buffer_view<Real, Complex, false>> = true;
 
 // We always allow a multi-d buffer for the same number of dimensions
-template <size_t D, class Real, class Complex, typename Layout, typename ExtentsIndexType,
-          ExtentsIndexType... I>
+template <size_t D, class Real, class Complex, typename Layout, class Storage,
+          typename ExtentsIndexType, ExtentsIndexType... I>
 constexpr inline bool appropriate_buffer<
     D, Real, Complex,
-    basic_mdbuffer<Real, MDSPAN::extents<ExtentsIndexType, I...>, Complex, Layout>> =
-    sizeof...(I) == D;
+    basic_mdbuffer<Real, MDSPAN::extents<ExtentsIndexType, I...>, Complex, Layout, false,
+                   Storage>> = sizeof...(I) == D;
 
 template <size_t D, class Real, class Complex, typename T, typename T2>
 concept appropriate_buffers =
@@ -77,6 +374,8 @@ class basic_plan : public plan_base<D, Real, Complex> {
 
     using base::c_plan;
     using base::plan_base;
+    using base::normalize;
+    using base::scale_factor;
 
     /// Executes the plan with the buffers provided initially.
     void operator()() const;
@@ -92,16 +391,30 @@ class basic_plan : public plan_base<D, Real, Complex> {
     /// \defgroup{planning utilities}
     template <typename BufferIn, typename BufferOut>
         requires appropriate_buffers<D, Real, Complex, BufferIn, BufferOut>
-    static auto dft(BufferIn &in, BufferOut &out, Direction direction, Flags flags) -> basic_plan;
+    static auto dft(BufferIn &in, BufferOut &out, Direction direction, Flags flags,
+                    int threads = 1) -> basic_plan;
 
     template <typename ViewIn, typename ViewOut>
         requires appropriate_views<D, Real, Complex, ViewIn, ViewOut>
-    static auto dft(ViewIn in, ViewOut out, Direction direction, Flags flags) -> basic_plan;
+    static auto dft(ViewIn in, ViewOut out, Direction direction, Flags flags, int threads = 1)
+        -> basic_plan;
+
+    /// Plans a transform along the selected axes of D-dimensional views only,
+    /// e.g. along t of an [x][y][t] cube. The remaining axes are looped over by FFTW itself
+    /// (guru howmany_dims), so there is no transposition or temporary buffer.
+    /// Axes are logical mdspan indices, independent of the layout; the extents of in and out
+    /// must match index by index.
+    template <typename ViewIn, typename ViewOut>
+        requires appropriate_views<D, Real, Complex, ViewIn, ViewOut>
+    static auto dft_axes(ViewIn in, ViewOut out, const std::vector<size_t> &axes,
+                         Direction direction, Flags flags, int threads = 1) -> basic_plan;
 };
 
 template <size_t D, class Real, class Complex>
 void basic_plan<D, Real, Complex>::operator()() const {
-    fftw_execute(c_plan());
+    auto timer = this->time_execution();
+    detail::fftw_types<Real>::execute(c_plan());
+    this->scale_planned_output();
 }
 
 /// used for a static_assert inside an else block of if constexpr
@@ -109,18 +422,23 @@ template <class...> inline constexpr bool always_false = false;
 
 namespace detail {
 
+template <bool IsReal, class Real, class Complex, class Storage>
+auto unwrap(basic_buffer<Real, Complex, IsReal, Storage> &buf) {
+    return buf.unwrap();
+}
+
 template <bool IsReal, class Real, class Complex>
-auto unwrap(basic_buffer<Real, Complex, IsReal> &buf) {
+auto unwrap(basic_buffer_view<Real, Complex, IsReal> &buf) {
     return buf.unwrap();
 }
 
 // TODO this is just a fix until we get a proper mdbuffer
-template <bool IsReal, typename Real, typename Complex, typename Extents, appropriate_layout Layout>
-auto unwrap(basic_mdbuffer<Real, Extents, Complex, Layout, IsReal> &buf) {
+template <bool IsReal, typename Real, typename Complex, typename Extents, appropriate_layout Layout,
+          class Storage>
+auto unwrap(basic_mdbuffer<Real, Extents, Complex, Layout, IsReal, Storage> &buf) {
     // for now, this is what FFT expects
     // TODO proper underlying element type
-    return reinterpret_cast<
-        typename basic_buffer<Real, Complex, IsReal>::underlying_element_type *>(buf.data());
+    return reinterpret_cast<underlying_element_type<IsReal, Real, Complex> *>(buf.data());
 }
 
 template <bool IsReal, typename Real, typename Complex, typename Extents, typename Layout>
@@ -132,21 +450,89 @@ auto *unwrap(MDSPAN::mdspan<std::conditional_t<IsReal, Real, Complex>, Extents,
     return reinterpret_cast<underlying_element_type<IsReal, Real, Complex> *>(view.data_handle());
 }
 
-template <size_t D, class Real, class Complex>
-    requires(D == 1u) && std::same_as<Real, double>
+/// Buffers and views without gaps between elements, which the basic interface can describe.
+/// basic_buffer has no layout and is always contiguous.
+template <typename T>
+concept contiguous = !requires { typename T::layout_type; } ||
+                     std::same_as<MDSPAN::layout_right, typename T::layout_type> ||
+                     std::same_as<MDSPAN::layout_left, typename T::layout_type>;
+
+/// Returns the view of an mdbuffer, or the view itself.
+template <typename T> auto as_view(T &x) {
+    if constexpr (mdarray_like<T>) {
+        return x.to_mdspan();
+    } else {
+        return x;
+    }
+}
 
-auto plan_dft(auto &in, auto &out, Direction direction, Flags flags) {
-    return fftw_plan_dft_1d(in.size(), unwrap<false, Real, Complex>(in),
-                            unwrap<false, Real, Complex>(out), direction, flags);
+/// Index of the view that becomes the k-th FFTW dimension.
+/// layout_left is reversed so that the last FFTW dimension is the contiguous one,
+/// which is also the one halved by real transforms.
+template <typename View> constexpr size_t fftw_index(size_t k) {
+    if constexpr (std::same_as<MDSPAN::layout_left, typename View::layout_type>) {
+        return View::rank() - 1 - k;
+    } else {
+        return k;
+    }
 }
 
-template <size_t D, class Real, class Complex>
-    requires(D == 2u) && std::same_as<Real, double>
+/// Extents of a view, in FFTW order.
+/// Every extent has to fit in an int; the total size may not, FFTW handles that internally.
+template <size_t D, typename View> std::array<int, D> fftw_extents(const View &view) {
+    std::array<int, D> n{};
+    for (size_t k = 0; k < D; ++k) {
+        auto extent = view.extent(fftw_index<View>(k));
+        if (std::uint64_t(extent) > std::uint64_t(std::numeric_limits<int>::max())) {
+            throw std::invalid_argument("extent too large for FFTW");
+        }
+        n[k] = int(extent);
+    }
+    return n;
+}
+
+/// Guru64 dimensions of a transform of size n (in FFTW order) between two views.
+/// Strides are in elements of each view, which is what FFTW expects.
+template <size_t D, class Real, typename ViewIn, typename ViewOut>
+auto guru_dims(const std::array<int, D> &n, const ViewIn &in, const ViewOut &out) {
+    std::array<typename fftw_types<Real>::iodim64, D> dims{};
+    for (size_t k = 0; k < D; ++k) {
+        dims[k].n = n[k];
+        dims[k].is = std::ptrdiff_t(in.stride(fftw_index<ViewIn>(k)));
+        dims[k].os = std::ptrdiff_t(out.stride(fftw_index<ViewOut>(k)));
+    }
+    return dims;
+}
+
+template <size_t D> std::array<int, D> dims(auto in, auto out);
+
+template <size_t D, class Real, class Complex, contiguous In, contiguous Out>
+    requires(D == 1u)
+auto plan_dft(In &in, Out &out, Direction direction, Flags flags) {
+    return fftw_types<Real>::plan_dft_1d(in.size(), unwrap<false, Real, Complex>(in),
+                                         unwrap<false, Real, Complex>(out), direction, flags);
+}
 
-auto plan_dft(auto &in, auto &out, Direction direction, Flags flags) {
-    // TODO for layout left this is different
-    return fftw_plan_dft_2d(in.extent(0), in.extent(1), unwrap<false, Real, Complex>(in),
-                            unwrap<false, Real, Complex>(out), direction, flags);
+template <size_t D, class Real, class Complex, contiguous In, contiguous Out>
+    requires(D >= 2u)
+auto plan_dft(In &in, Out &out, Direction direction, Flags flags) {
+    auto n = dims<D>(as_view(in), as_view(out));
+    return fftw_types<Real>::plan_dft(int(D), n.data(), unwrap<false, Real, Complex>(in),
+                                      unwrap<false, Real, Complex>(out), direction, flags);
+}
+
+template <size_t D, class Real, class Complex, typename In, typename Out>
+    requires(!contiguous<In> || !contiguous<Out>)
+auto plan_dft(In &in, Out &out, Direction direction, Flags flags) {
+    auto in_view = as_view(in);
+    auto out_view = as_view(out);
+    auto n = fftw_extents<D>(in_view);
+    if (n != fftw_extents<D>(out_view)) { throw std::invalid_argument("Extents don't match"); }
+    auto guru = guru_dims<D, Real>(n, in_view, out_view);
+    return fftw_types<Real>::plan_guru64_dft(D, guru.data(), 0, nullptr,
+                                             unwrap<false, Real, Complex>(in_view),
+                                             unwrap<false, Real, Complex>(out_view), direction,
+                                             flags);
 }
 } // namespace detail
 
@@ -154,45 +540,129 @@ template <size_t D, class Real, class Complex>
 template <typename BufferIn, typename BufferOut>
     requires appropriate_buffers<D, Real, Complex, BufferIn, BufferOut>
 void basic_plan<D, Real, Complex>::operator()(BufferIn &in, BufferOut &out) const {
-    fftw_execute_dft(c_plan(), detail::unwrap<false, Real, Complex>(in),
-                     detail::unwrap<false, Real, Complex>(out));
+    auto timer = this->time_execution();
+    auto *in_ptr = detail::unwrap<false, Real, Complex>(in);
+    auto *out_ptr = detail::unwrap<false, Real, Complex>(out);
+    detail::fftw_types<Real>::execute_dft(this->plan_for(in_ptr, out_ptr), in_ptr, out_ptr);
+    this->scale_output(out);
 }
 
 template <size_t D, class Real, class Complex>
 template <typename ViewIn, typename ViewOut>
     requires appropriate_views<D, Real, Complex, ViewIn, ViewOut>
 void basic_plan<D, Real, Complex>::operator()(ViewIn in, ViewOut out) const {
-    fftw_execute_dft(c_plan(), detail::unwrap<false, Real, Complex>(in),
-                     detail::unwrap<false, Real, Complex>(out));
+    auto timer = this->time_execution();
+    auto *in_ptr = detail::unwrap<false, Real, Complex>(in);
+    auto *out_ptr = detail::unwrap<false, Real, Complex>(out);
+    detail::fftw_types<Real>::execute_dft(this->plan_for(in_ptr, out_ptr), in_ptr, out_ptr);
+    this->scale_output(out);
 }
 
 template <size_t D, class Real, class Complex>
 template <typename BufferIn, typename BufferOut>
     requires appropriate_buffers<D, Real, Complex, BufferIn, BufferOut>
 auto basic_plan<D, Real, Complex>::dft(BufferIn &in, BufferOut &out, Direction direction,
-                                       Flags flags) -> basic_plan {
+                                       Flags flags, int threads) -> basic_plan {
     if (in.size() != out.size()) { throw std::invalid_argument("mismatched buffer sizes"); }
     if (direction != FORWARD and direction != BACKWARD) {
         throw std::invalid_argument("invalid direction");
     }
 
+    std::lock_guard lock{detail::planner_mutex()};
+    detail::plan_with_threads<Real>(threads);
     auto c_plan = detail::template plan_dft<D, Real, Complex>(in, out, direction, flags);
-    return basic_plan{c_plan};
+    basic_plan plan{detail::require_plan(c_plan)};
+    plan.enable_normalization(out, size_t(out.size()), direction);
+    plan.enable_fallback(in, out, flags, [direction, threads](auto &in, auto &out, Flags flags) {
+        detail::plan_with_threads<Real>(threads);
+        return detail::template plan_dft<D, Real, Complex>(in, out, direction, flags);
+    });
+    return plan;
 }
 
 // TODO dedup
 template <size_t D, class Real, class Complex>
 template <typename ViewIn, typename ViewOut>
     requires appropriate_views<D, Real, Complex, ViewIn, ViewOut>
-auto basic_plan<D, Real, Complex>::dft(ViewIn in, ViewOut out, Direction direction, Flags flags)
-    -> basic_plan {
+auto basic_plan<D, Real, Complex>::dft(ViewIn in, ViewOut out, Direction direction, Flags flags,
+                                       int threads) -> basic_plan {
     if (in.size() != out.size()) { throw std::invalid_argument("mismatched buffer sizes"); }
     if (direction != FORWARD and direction != BACKWARD) {
         throw std::invalid_argument("invalid direction");
     }
 
+    std::lock_guard lock{detail::planner_mutex()};
+    detail::plan_with_threads<Real>(threads);
     auto c_plan = detail::template plan_dft<D, Real, Complex>(in, out, direction, flags);
-    return basic_plan{c_plan};
+    basic_plan plan{detail::require_plan(c_plan)};
+    plan.enable_normalization(out, size_t(out.size()), direction);
+    plan.enable_fallback(in, out, flags, [direction, threads](auto &in, auto &out, Flags flags) {
+        detail::plan_with_threads<Real>(threads);
+        return detail::template plan_dft<D, Real, Complex>(in, out, direction, flags);
+    });
+    return plan;
+}
+
+namespace detail {
+/// Splits the dimensions of two views into the transformed ones (the axes, in increasing order)
+/// and the looped ones, as guru64 dims and howmany_dims.
+template <size_t D, class Real>
+auto guru_axes(const auto &in, const auto &out, const std::vector<size_t> &axes) {
+    using iodim = typename fftw_types<Real>::iodim64;
+
+    auto Validate = [&](bool condition, const char *message) {
+        if (!condition) { throw std::invalid_argument(message); }
+    };
+
+    std::array<bool, D> selected{};
+    for (auto axis : axes) {
+        Validate(axis < D, "axis out of range");
+        Validate(!selected[axis], "duplicate axis");
+        selected[axis] = true;
+    }
+    Validate(!axes.empty(), "no axes to transform");
+
+    std::vector<iodim> dims, howmany_dims;
+    for (size_t i = 0; i < D; ++i) {
+        Validate(in.extent(i) == out.extent(i), "Extents don't match");
+        iodim dim{};
+        dim.n = std::ptrdiff_t(in.extent(i));
+        dim.is = std::ptrdiff_t(in.stride(i));
+        dim.os = std::ptrdiff_t(out.stride(i));
+        (selected[i] ? dims : howmany_dims).push_back(dim);
+    }
+    return std::pair{std::move(dims), std::move(howmany_dims)};
+}
+} // namespace detail
+
+template <size_t D, class Real, class Complex>
+template <typename ViewIn, typename ViewOut>
+    requires appropriate_views<D, Real, Complex, ViewIn, ViewOut>
+auto basic_plan<D, Real, Complex>::dft_axes(ViewIn in, ViewOut out,
+                                            const std::vector<size_t> &axes, Direction direction,
+                                            Flags flags, int threads) -> basic_plan {
+    if (direction != FORWARD and direction != BACKWARD) {
+        throw std::invalid_argument("invalid direction");
+    }
+
+    auto Planner = [axes, direction, threads](auto &in, auto &out, Flags flags) {
+        auto [dims, howmany_dims] = detail::guru_axes<D, Real>(in, out, axes);
+        detail::plan_with_threads<Real>(threads);
+        return detail::fftw_types<Real>::plan_guru64_dft(
+            int(dims.size()), dims.data(), int(howmany_dims.size()), howmany_dims.data(),
+            detail::unwrap<false, Real, Complex>(in), detail::unwrap<false, Real, Complex>(out),
+            direction, flags);
+    };
+
+    std::lock_guard lock{detail::planner_mutex()};
+    basic_plan plan{detail::require_plan(Planner(in, out, flags))};
+    size_t n = 1;
+    for (auto axis : axes) {
+        n *= size_t(out.extent(axis));
+    }
+    plan.enable_normalization(out, n, direction);
+    plan.enable_fallback(in, out, flags, Planner);
+    return plan;
 }
 
 template <size_t D, class Real, class Complex = std::complex<Real>>
@@ -207,6 +677,8 @@ class basic_plan_r2c : public plan_base<D, Real, Complex> {
 
     using base::c_plan;
     using base::plan_base;
+    using base::normalize;
+    using base::scale_factor;
 
     /// Executes the plan with the buffers provided initially.
     void operator()() const;
@@ -215,7 +687,7 @@ class basic_plan_r2c : public plan_base<D, Real, Complex> {
 
     /// \defgroup{planning utilities}
     template <typename ViewIn, typename ViewOut>
-    static auto dft(ViewIn in, ViewOut out, Flags flags) -> basic_plan_r2c;
+    static auto dft(ViewIn in, ViewOut out, Flags flags, int threads = 1) -> basic_plan_r2c;
 };
 
 template <size_t D, class Real, class Complex = std::complex<Real>>
@@ -230,6 +702,8 @@ class basic_plan_c2r : public plan_base<D, Real, Complex> {
 
     using base::c_plan;
     using base::plan_base;
+    using base::normalize;
+    using base::scale_factor;
 
     /// Executes the plan with the buffers provided initially.
     void operator()() const;
@@ -238,31 +712,41 @@ class basic_plan_c2r : public plan_base<D, Real, Complex> {
 
     /// \defgroup{planning utilities}
     template <typename ViewIn, typename ViewOut>
-    static auto dft(ViewIn in, ViewOut out, Flags flags) -> basic_plan_c2r;
+    static auto dft(ViewIn in, ViewOut out, Flags flags, int threads = 1) -> basic_plan_c2r;
 };
 
 template <size_t D, class Real, class Complex>
 void basic_plan_r2c<D, Real, Complex>::operator()() const {
-    fftw_execute(c_plan());
+    auto timer = this->time_execution();
+    detail::fftw_types<Real>::execute(c_plan());
+    this->scale_planned_output();
 }
 
 template <size_t D, class Real, class Complex>
 template <typename ViewIn, typename ViewOut>
 void basic_plan_r2c<D, Real, Complex>::operator()(ViewIn in, ViewOut out) const {
-    fftw_execute_dft_r2c(c_plan(), detail::unwrap<true, Real, Complex>(in),
-                         detail::unwrap<false, Real, Complex>(out));
+    auto timer = this->time_execution();
+    auto *in_ptr = detail::unwrap<true, Real, Complex>(in);
+    auto *out_ptr = detail::unwrap<false, Real, Complex>(out);
+    detail::fftw_types<Real>::execute_dft_r2c(this->plan_for(in_ptr, out_ptr), in_ptr, out_ptr);
+    this->scale_output(out);
 }
 
 template <size_t D, class Real, class Complex>
 void basic_plan_c2r<D, Real, Complex>::operator()() const {
-    fftw_execute(c_plan());
+    auto timer = this->time_execution();
+    detail::fftw_types<Real>::execute(c_plan());
+    this->scale_planned_output();
 }
 
 template <size_t D, class Real, class Complex>
 template <typename ViewIn, typename ViewOut>
 void basic_plan_c2r<D, Real, Complex>::operator()(ViewIn in, ViewOut out) const {
-    fftw_execute_dft_c2r(c_plan(), detail::unwrap<false, Real, Complex>(in),
-                         detail::unwrap<true, Real, Complex>(out));
+    auto timer = this->time_execution();
+    auto *in_ptr = detail::unwrap<false, Real, Complex>(in);
+    auto *out_ptr = detail::unwrap<true, Real, Complex>(out);
+    detail::fftw_types<Real>::execute_dft_c2r(this->plan_for(in_ptr, out_ptr), in_ptr, out_ptr);
+    this->scale_output(out);
 }
 
 namespace detail {
@@ -273,31 +757,13 @@ namespace detail {
 //  If people really want to switch layouts they'll have to reverse it themselves.
 
 template <size_t D> std::array<int, D> dims(auto in, auto out) {
-    static_assert(D == 2u && "Currently only supporting 2D");
-    using layout_in = typename std::decay_t<decltype(in)>::layout_type;
-    using layout_out = typename std::decay_t<decltype(out)>::layout_type;
-
-    // TODO layouts other than right and left
-    constexpr bool in_right = std::same_as<MDSPAN::layout_right, layout_in>;
-    constexpr bool out_right = std::same_as<MDSPAN::layout_right, layout_out>;
-
     auto Validate = [&](bool condition) {
         if (!condition) { throw std::invalid_argument("Extents don't match"); }
     };
 
-    if (in_right == out_right) {
-        Validate(in.extent(0) == out.extent(0));
-        Validate(in.extent(1) == out.extent(1));
-    } else {
-        Validate(in.extent(0) == out.extent(1));
-        Validate(in.extent(1) == out.extent(0));
-    }
-
-    if constexpr (in_right) {
-        return {int(in.extent(0)), int(in.extent(1))};
-    } else {
-        return {int(in.extent(1)), int(in.extent(0))};
-    }
+    auto n = fftw_extents<D>(in);
+    Validate(n == fftw_extents<D>(out));
+    return n;
 }
 
 template <size_t... I> auto extents_impl(auto src, std::index_sequence<I...> indices) {
@@ -308,61 +774,99 @@ template <size_t D> std::array<int, D> extents(auto src) {
     return extents_impl(src, std::make_index_sequence<D>());
 }
 
+/// Validates the extents of a real and a complex view and returns the (real) transform size.
+/// All dimensions match except the last one in FFTW order, which is n / 2 + 1 for the complex view.
+/// In-place transforms (both views on the same memory) need the real view to be padded like
+/// layout_r2c_padded: every complex element takes the place of exactly two reals.
 template <size_t D> std::array<int, D> dims_r2c(auto r, auto c) {
-    static_assert(D == 2u && "Currently only supporting 2D");
-    using layout_r = typename std::decay_t<decltype(r)>::layout_type;
-    using layout_c = typename std::decay_t<decltype(c)>::layout_type;
-
-    // TODO layouts other than right and left
-    constexpr bool r_right = std::same_as<MDSPAN::layout_right, layout_r>;
-    constexpr bool c_right = std::same_as<MDSPAN::layout_right, layout_c>;
+    static_assert(D >= 1u);
 
     auto Validate = [&](bool condition) {
         if (!condition) { throw std::invalid_argument("Extents don't match"); }
     };
+    auto ValidatePadding = [&](bool condition) {
+        if (!condition) {
+            throw std::invalid_argument("In-place real transforms need the padded real layout");
+        }
+    };
 
-    std::array<int, D> r_extents{extents<D>(r)}, c_extents{extents<D>(c)};
-    auto Swap = [&](std::array<int, D> &a) { std::swap(a[0], a[1]); };
-
-    if (!r_right) { Swap(r_extents); }
-    if (!c_right) { Swap(c_extents); }
-    // extent
+    std::array<int, D> r_extents{fftw_extents<D>(r)}, c_extents{fftw_extents<D>(c)};
 
-    Validate(r_extents[0] == c_extents[0]);
-    Validate(r_extents[1] / 2 + 1 == c_extents[1]);
+    for (size_t k = 0; k + 1 < D; ++k) {
+        Validate(r_extents[k] == c_extents[k]);
+    }
+    Validate(r_extents[D - 1] / 2 + 1 == c_extents[D - 1]);
+
+    using R = decltype(r);
+    using C = decltype(c);
+    if (static_cast<const void *>(r.data_handle()) == static_cast<const void *>(c.data_handle())) {
+        for (size_t k = 0; k < D; ++k) {
+            auto r_stride = std::ptrdiff_t(r.stride(fftw_index<R>(k)));
+            auto c_stride = std::ptrdiff_t(c.stride(fftw_index<C>(k)));
+            ValidatePadding(k + 1 == D ? r_stride == c_stride : r_stride == 2 * c_stride);
+        }
+    }
 
     return r_extents;
 }
 
-template <size_t D, class Real, class Complex>
-    requires std::same_as<Real, double>
-auto plan_dft_r2c(auto in, auto out, Flags flags) {
-    return fftw_plan_dft_r2c(D, dims_r2c<D>(in, out).data(), unwrap<true, Real, Complex>(in),
-                             unwrap<false, Real, Complex>(out), flags);
+template <size_t D, class Real, class Complex> auto plan_dft_r2c(auto in, auto out, Flags flags) {
+    auto n = dims_r2c<D>(in, out);
+    if constexpr (contiguous<decltype(in)> && contiguous<decltype(out)>) {
+        return fftw_types<Real>::plan_dft_r2c(D, n.data(), unwrap<true, Real, Complex>(in),
+                                              unwrap<false, Real, Complex>(out), flags);
+    } else {
+        auto guru = guru_dims<D, Real>(n, in, out);
+        return fftw_types<Real>::plan_guru64_dft_r2c(D, guru.data(), 0, nullptr,
+                                                     unwrap<true, Real, Complex>(in),
+                                                     unwrap<false, Real, Complex>(out), flags);
+    }
 }
 
-template <size_t D, class Real, class Complex>
-    requires std::same_as<Real, double>
-auto plan_dft_c2r(auto in, auto out, Flags flags) {
-    return fftw_plan_dft_c2r(D, dims_r2c<D>(out, in).data(), unwrap<false, Real, Complex>(in),
-                             unwrap<true, Real, Complex>(out), flags);
+template <size_t D, class Real, class Complex> auto plan_dft_c2r(auto in, auto out, Flags flags) {
+    auto n = dims_r2c<D>(out, in);
+    if constexpr (contiguous<decltype(in)> && contiguous<decltype(out)>) {
+        return fftw_types<Real>::plan_dft_c2r(D, n.data(), unwrap<false, Real, Complex>(in),
+                                              unwrap<true, Real, Complex>(out), flags);
+    } else {
+        auto guru = guru_dims<D, Real>(n, in, out);
+        return fftw_types<Real>::plan_guru64_dft_c2r(D, guru.data(), 0, nullptr,
+                                                     unwrap<false, Real, Complex>(in),
+                                                     unwrap<true, Real, Complex>(out), flags);
+    }
 }
 } // namespace detail
 
 template <size_t D, class Real, class Complex>
 template <typename ViewIn, typename ViewOut>
-auto basic_plan_r2c<D, Real, Complex>::dft(ViewIn in, ViewOut out, fftw::Flags flags)
+auto basic_plan_r2c<D, Real, Complex>::dft(ViewIn in, ViewOut out, fftw::Flags flags, int threads)
     -> basic_plan_r2c<D, Real, Complex> {
+    std::lock_guard lock{detail::planner_mutex()};
+    detail::plan_with_threads<Real>(threads);
     auto c_plan = detail::template plan_dft_r2c<D, Real, Complex>(in, out, flags);
-    return basic_plan_r2c{c_plan};
+    basic_plan_r2c plan{detail::require_plan(c_plan)};
+    plan.enable_normalization(out, size_t(in.size()), FORWARD);
+    plan.enable_fallback(in, out, flags, [threads](auto &in, auto &out, Flags flags) {
+        detail::plan_with_threads<Real>(threads);
+        return detail::template plan_dft_r2c<D, Real, Complex>(in, out, flags);
+    });
+    return plan;
 }
 
 template <size_t D, class Real, class Complex>
 template <typename ViewIn, typename ViewOut>
-auto basic_plan_c2r<D, Real, Complex>::dft(ViewIn in, ViewOut out, fftw::Flags flags)
+auto basic_plan_c2r<D, Real, Complex>::dft(ViewIn in, ViewOut out, fftw::Flags flags, int threads)
     -> basic_plan_c2r<D, Real, Complex> {
+    std::lock_guard lock{detail::planner_mutex()};
+    detail::plan_with_threads<Real>(threads);
     auto c_plan = detail::template plan_dft_c2r<D, Real, Complex>(in, out, flags);
-    return basic_plan_c2r{c_plan};
+    basic_plan_c2r plan{detail::require_plan(c_plan)};
+    plan.enable_normalization(out, size_t(out.size()), BACKWARD);
+    plan.enable_fallback(in, out, flags, [threads](auto &in, auto &out, Flags flags) {
+        detail::plan_with_threads<Real>(threads);
+        return detail::template plan_dft_c2r<D, Real, Complex>(in, out, flags);
+    });
+    return plan;
 }
 
 } // namespace fftw
\ No newline at end of file
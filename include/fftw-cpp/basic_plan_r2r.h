@@ -0,0 +1,251 @@
+#pragma once
+
+#include "basic_buffer.h"
+#include "basic_plan.h"
+#include "util.h"
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+
+namespace fftw {
+
+/// The kind of a real-to-real transform along one dimension, see the FFTW manual
+/// ("Real-to-Real Transform Kinds"). REDFT are DCTs, RODFT are DSTs: REDFT10 is the DCT-II,
+/// REDFT01 the DCT-III (its inverse up to scaling), RODFT10 the DST-II, and so on.
+enum class R2RKind {
+    R2HC = FFTW_R2HC,
+    HC2R = FFTW_HC2R,
+    DHT = FFTW_DHT,
+    REDFT00 = FFTW_REDFT00,
+    REDFT01 = FFTW_REDFT01,
+    REDFT10 = FFTW_REDFT10,
+    REDFT11 = FFTW_REDFT11,
+    RODFT00 = FFTW_RODFT00,
+    RODFT01 = FFTW_RODFT01,
+    RODFT10 = FFTW_RODFT10,
+    RODFT11 = FFTW_RODFT11,
+};
+
+/// The logical size N of a transform of n elements, as defined by FFTW. Like the complex
+/// transforms, r2r transforms are unnormalized: a transform followed by its inverse (e.g.
+/// REDFT10 then REDFT01) multiplies the data by the product of N over all dimensions.
+constexpr std::ptrdiff_t logical_size(R2RKind kind, std::ptrdiff_t n) {
+    switch (kind) {
+    case R2RKind::REDFT00:
+        return 2 * (n - 1);
+    case R2RKind::RODFT00:
+        return 2 * (n + 1);
+    case R2RKind::REDFT01:
+    case R2RKind::REDFT10:
+    case R2RKind::REDFT11:
+    case R2RKind::RODFT01:
+    case R2RKind::RODFT10:
+    case R2RKind::RODFT11:
+        return 2 * n;
+    default:
+        return n;
+    }
+}
+
+/// This boolean checks that the real buffer is appropriate for an r2r plan.
+/// By default, it is false
+template <size_t D, class Real, class Complex, typename T>
+constexpr inline bool appropriate_real_buffer = false;
+
+// We allow basic_rbuffer for 1D transforms, with any storage policy
+template <class Real, class Complex, class Storage>
+constexpr inline bool
+    appropriate_real_buffer<1u, Real, Complex, basic_rbuffer<Real, Complex, Storage>> = true;
+
+// We allow non-owning views of user memory for 1D transforms
+template <class Real, class Complex>
+constexpr inline bool
+    appropriate_real_buffer<1u, Real, Complex, basic_rbuffer_view<Real, Complex>> = true;
+
+// We always allow a multi-d real buffer for the same number of dimensions
+template <size_t D, class Real, class Complex, appropriate_layout Layout, class Storage,
+          typename ExtentsIndexType, ExtentsIndexType... I>
+constexpr inline bool appropriate_real_buffer<
+    D, Real, Complex,
+    basic_mdbuffer<Real, MDSPAN::extents<ExtentsIndexType, I...>, Complex, Layout, true,
+                   Storage>> = sizeof...(I) == D;
+
+template <size_t D, class Real, class Complex, typename T, typename T2>
+concept appropriate_real_buffers =
+    appropriate_real_buffer<D, Real, Complex, T> && appropriate_real_buffer<D, Real, Complex, T2>;
+
+/// This boolean checks that the real view is appropriate for an r2r plan.
+/// By default, it is false
+template <size_t D, class Real, typename T> constexpr inline bool appropriate_real_view = false;
+
+template <size_t D, class Real, appropriate_layout Layout, typename ExtentsIndexType,
+          ExtentsIndexType... I>
+constexpr inline bool appropriate_real_view<
+    D, Real,
+    MDSPAN::mdspan<Real, MDSPAN::extents<ExtentsIndexType, I...>, Layout,
+                   MDSPAN::default_accessor<Real>>> = sizeof...(I) == D;
+
+template <size_t D, class Real, typename T, typename T2>
+concept appropriate_real_views =
+    appropriate_real_view<D, Real, T> && appropriate_real_view<D, Real, T2>;
+
+/// A real-to-real transform (DCT, DST, DHT or halfcomplex DFT) of rank D, with one kind per
+/// dimension. Kinds are given per mdspan index, whatever the layout.
+template <size_t D, class Real, class Complex = std::complex<Real>>
+class basic_plan_r2r : public plan_base<D, Real, Complex> {
+  private:
+    using base = plan_base<D, Real, Complex>;
+    using plan_t = typename base::plan_t;
+
+  public:
+    using real_t = Real;
+    using complex_t = Complex;
+    using kinds_t = std::array<R2RKind, D>;
+
+    using base::c_plan;
+    using base::plan_base;
+
+    /// Executes the plan with the buffers provided initially.
+    void operator()() const;
+
+    template <typename BufferIn, typename BufferOut>
+        requires appropriate_real_buffers<D, Real, Complex, BufferIn, BufferOut>
+    void operator()(BufferIn &in, BufferOut &out) const;
+
+    template <typename ViewIn, typename ViewOut>
+        requires appropriate_real_views<D, Real, ViewIn, ViewOut>
+    void operator()(ViewIn in, ViewOut out) const;
+
+    /// \defgroup{planning utilities}
+    template <typename BufferIn, typename BufferOut>
+        requires appropriate_real_buffers<D, Real, Complex, BufferIn, BufferOut>
+    static auto dft(BufferIn &in, BufferOut &out, const kinds_t &kinds, Flags flags,
+                    int threads = 1) -> basic_plan_r2r;
+
+    template <typename ViewIn, typename ViewOut>
+        requires appropriate_real_views<D, Real, ViewIn, ViewOut>
+    static auto dft(ViewIn in, ViewOut out, const kinds_t &kinds, Flags flags, int threads = 1)
+        -> basic_plan_r2r;
+
+    /// The same kind along every dimension.
+    template <typename In, typename Out>
+    static auto dft(In &&in, Out &&out, R2RKind kind, Flags flags, int threads = 1)
+        -> basic_plan_r2r {
+        kinds_t kinds;
+        kinds.fill(kind);
+        return dft(std::forward<In>(in), std::forward<Out>(out), kinds, flags, threads);
+    }
+};
+
+namespace detail {
+
+template <size_t D, class Real, class Complex, typename In, typename Out>
+auto plan_r2r(In &in, Out &out, const std::array<R2RKind, D> &kinds, Flags flags) {
+    using types = fftw_types<Real>;
+    using r2r_kind = typename types::r2r_kind;
+
+    auto Validate = [&](bool condition) {
+        if (!condition) { throw std::invalid_argument("Extents don't match"); }
+    };
+
+    if constexpr (buffer_like<In> || buffer_like<Out>) {
+        static_assert(D == 1u);
+        Validate(in.size() == out.size());
+        if (kinds[0] == R2RKind::REDFT00 && in.size() < 2) {
+            throw std::invalid_argument("REDFT00 requires at least 2 elements");
+        }
+        int n = int(in.size());
+        auto kind = r2r_kind(kinds[0]);
+        return types::plan_r2r(1, &n, unwrap<true, Real, Complex>(in),
+                               unwrap<true, Real, Complex>(out), &kind, flags);
+    } else {
+        auto in_view = as_view(in);
+        auto out_view = as_view(out);
+        auto n = fftw_extents<D>(in_view);
+        Validate(n == fftw_extents<D>(out_view));
+
+        // kinds are given per index of the input, FFTW wants them in its own order
+        std::array<r2r_kind, D> fftw_kinds{};
+        for (size_t k = 0; k < D; ++k) {
+            auto kind = kinds[fftw_index<decltype(in_view)>(k)];
+            if (kind == R2RKind::REDFT00 && n[k] < 2) {
+                throw std::invalid_argument("REDFT00 requires at least 2 elements");
+            }
+            fftw_kinds[k] = r2r_kind(kind);
+        }
+
+        if constexpr (contiguous<In> && contiguous<Out>) {
+            return types::plan_r2r(int(D), n.data(), unwrap<true, Real, Complex>(in_view),
+                                   unwrap<true, Real, Complex>(out_view), fftw_kinds.data(),
+                                   flags);
+        } else {
+            auto guru = guru_dims<D, Real>(n, in_view, out_view);
+            return types::plan_guru64_r2r(int(D), guru.data(), 0, nullptr,
+                                          unwrap<true, Real, Complex>(in_view),
+                                          unwrap<true, Real, Complex>(out_view),
+                                          fftw_kinds.data(), flags);
+        }
+    }
+}
+
+} // namespace detail
+
+template <size_t D, class Real, class Complex>
+void basic_plan_r2r<D, Real, Complex>::operator()() const {
+    auto timer = this->time_execution();
+    detail::fftw_types<Real>::execute(c_plan());
+}
+
+template <size_t D, class Real, class Complex>
+template <typename BufferIn, typename BufferOut>
+    requires appropriate_real_buffers<D, Real, Complex, BufferIn, BufferOut>
+void basic_plan_r2r<D, Real, Complex>::operator()(BufferIn &in, BufferOut &out) const {
+    auto timer = this->time_execution();
+    auto *in_ptr = detail::unwrap<true, Real, Complex>(in);
+    auto *out_ptr = detail::unwrap<true, Real, Complex>(out);
+    detail::fftw_types<Real>::execute_r2r(this->plan_for(in_ptr, out_ptr), in_ptr, out_ptr);
+}
+
+template <size_t D, class Real, class Complex>
+template <typename ViewIn, typename ViewOut>
+    requires appropriate_real_views<D, Real, ViewIn, ViewOut>
+void basic_plan_r2r<D, Real, Complex>::operator()(ViewIn in, ViewOut out) const {
+    auto timer = this->time_execution();
+    auto *in_ptr = detail::unwrap<true, Real, Complex>(in);
+    auto *out_ptr = detail::unwrap<true, Real, Complex>(out);
+    detail::fftw_types<Real>::execute_r2r(this->plan_for(in_ptr, out_ptr), in_ptr, out_ptr);
+}
+
+template <size_t D, class Real, class Complex>
+template <typename BufferIn, typename BufferOut>
+    requires appropriate_real_buffers<D, Real, Complex, BufferIn, BufferOut>
+auto basic_plan_r2r<D, Real, Complex>::dft(BufferIn &in, BufferOut &out, const kinds_t &kinds,
+                                           Flags flags, int threads) -> basic_plan_r2r {
+    std::lock_guard lock{detail::planner_mutex()};
+    detail::plan_with_threads<Real>(threads);
+    auto c_plan = detail::template plan_r2r<D, Real, Complex>(in, out, kinds, flags);
+    basic_plan_r2r plan{detail::require_plan(c_plan)};
+    plan.enable_fallback(in, out, flags, [kinds, threads](auto &in, auto &out, Flags flags) {
+        detail::plan_with_threads<Real>(threads);
+        return detail::template plan_r2r<D, Real, Complex>(in, out, kinds, flags);
+    });
+    return plan;
+}
+
+template <size_t D, class Real, class Complex>
+template <typename ViewIn, typename ViewOut>
+    requires appropriate_real_views<D, Real, ViewIn, ViewOut>
+auto basic_plan_r2r<D, Real, Complex>::dft(ViewIn in, ViewOut out, const kinds_t &kinds,
+                                           Flags flags, int threads) -> basic_plan_r2r {
+    std::lock_guard lock{detail::planner_mutex()};
+    detail::plan_with_threads<Real>(threads);
+    auto c_plan = detail::template plan_r2r<D, Real, Complex>(in, out, kinds, flags);
+    basic_plan_r2r plan{detail::require_plan(c_plan)};
+    plan.enable_fallback(in, out, flags, [kinds, threads](auto &in, auto &out, Flags flags) {
+        detail::plan_with_threads<Real>(threads);
+        return detail::template plan_r2r<D, Real, Complex>(in, out, kinds, flags);
+    });
+    return plan;
+}
+
+} // namespace fftw
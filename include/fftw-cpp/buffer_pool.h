@@ -0,0 +1,246 @@
+#pragma once
+
+#include "util.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace fftw {
+
+/// Counters reported by buffer_pool::stats().
+struct buffer_pool_stats {
+    size_t hits{0};         ///< allocations served from a cache
+    size_t misses{0};       ///< allocations that had to call fftw_malloc
+    size_t oversized{0};    ///< allocations larger than max_block, never pooled
+    size_t cached_bytes{0}; ///< bytes held by all thread caches and the shared free list
+    size_t shared_bytes{0}; ///< bytes held by the shared free list
+};
+
+/// A pool of SIMD-aligned memory blocks in power-of-two size classes, for buffers that are
+/// created and destroyed constantly (e.g. per-request scratch buffers).
+/// Blocks come from fftw_malloc, so pooled buffers keep the alignment of basic_buffer and plans
+/// created on them stay on the aligned SIMD path.
+///
+/// A freed block goes to a small cache of the freeing thread first (no locking), then to a
+/// shared free list up to capacity(), and only beyond that back to fftw_free.
+/// There is one pool per precision; buffers use it through the pool_allocator storage policy:
+/// \code
+/// fftw::pooled_buffer scratch(n); // reuses the memory of an earlier pooled buffer of similar size
+/// \endcode
+template <std::floating_point Real> class buffer_pool {
+  public:
+    static constexpr size_t min_block = 64;        ///< bytes, the smallest size class
+    static constexpr size_t max_block = 256 << 20; ///< bytes, larger blocks bypass the pool
+    static constexpr size_t thread_cache_blocks = 4; ///< per size class and thread
+
+    /// The pool of this precision.
+    static buffer_pool &global();
+
+    buffer_pool(const buffer_pool &) = delete;
+    buffer_pool &operator=(const buffer_pool &) = delete;
+    ~buffer_pool();
+
+    /// Returns a block of at least `bytes`, aligned like fftw_malloc.
+    void *allocate(size_t bytes);
+
+    /// Returns a block to the pool; `bytes` must be the size passed to allocate.
+    void deallocate(void *ptr, size_t bytes) noexcept;
+
+    /// Releases the shared free list and the calling thread's cache to fftw_free.
+    /// The caches of other threads are released when those threads call trim() or exit.
+    void trim();
+
+    /// Maximum number of bytes kept in the shared free list (256 MiB by default).
+    void set_capacity(size_t bytes);
+    [[nodiscard]] size_t capacity() const;
+
+    [[nodiscard]] buffer_pool_stats stats() const;
+
+  private:
+    static constexpr size_t num_classes = std::bit_width(max_block / min_block);
+    using free_lists = std::array<std::vector<void *>, num_classes>;
+
+    struct thread_cache {
+        free_lists blocks;
+        thread_cache();
+        ~thread_cache();
+    };
+
+    buffer_pool() = default;
+
+    /// The size class of an allocation, or nothing if it is too large to pool.
+    static std::optional<size_t> size_class(size_t bytes);
+    static size_t block_size(size_t cls) { return min_block << cls; }
+
+    static thread_cache *local();
+    void release(free_lists &lists, bool shared) noexcept;
+
+    mutable std::mutex mutex;
+    free_lists shared; // guarded by mutex
+    size_t shared_bytes{0}; // guarded by mutex
+    size_t max_shared_bytes{256 << 20}; // guarded by mutex
+
+    std::atomic<size_t> hits{0}, misses{0}, oversized{0}, cached_bytes{0};
+};
+
+/// A storage policy for basic_buffer and basic_mdbuffer that draws from buffer_pool<Real>.
+template <std::floating_point Real> struct pool_allocator {
+    static void *allocate(size_t bytes) { return buffer_pool<Real>::global().allocate(bytes); }
+    static void deallocate(void *ptr, size_t bytes) noexcept {
+        buffer_pool<Real>::global().deallocate(ptr, bytes);
+    }
+};
+
+template <std::floating_point Real> buffer_pool<Real> &buffer_pool<Real>::global() {
+    static buffer_pool pool;
+    return pool;
+}
+
+template <std::floating_point Real> buffer_pool<Real>::~buffer_pool() { release(shared, true); }
+
+template <std::floating_point Real> buffer_pool<Real>::thread_cache::thread_cache() {
+    for (auto &list : blocks) {
+        // deallocate never allocates on the fast path
+        list.reserve(thread_cache_blocks);
+    }
+}
+
+template <std::floating_point Real> buffer_pool<Real>::thread_cache::~thread_cache() {
+    global().release(blocks, false);
+}
+
+template <std::floating_point Real> auto buffer_pool<Real>::local() -> thread_cache * {
+    // constructing the pool first guarantees it outlives the caches
+    global();
+    // the flag is trivially destructible, so buffers destroyed during thread exit
+    // (after the cache) can still check it and fall back to the shared list
+    static thread_local bool destroyed = false;
+    struct guarded_cache : thread_cache {
+        ~guarded_cache() { destroyed = true; }
+    };
+    if (destroyed) { return nullptr; }
+    static thread_local guarded_cache cache;
+    return &cache;
+}
+
+template <std::floating_point Real>
+std::optional<size_t> buffer_pool<Real>::size_class(size_t bytes) {
+    if (bytes > max_block) { return std::nullopt; }
+    auto blocks = (std::max(bytes, min_block) + min_block - 1) / min_block;
+    return size_t(std::bit_width(blocks - 1));
+}
+
+template <std::floating_point Real> void *buffer_pool<Real>::allocate(size_t bytes) {
+    using types = detail::fftw_types<Real>;
+    auto cls = size_class(bytes);
+    if (!cls) {
+        ++oversized;
+        return types::malloc(bytes);
+    }
+    auto size = block_size(*cls);
+
+    if (auto *cache = local(); cache != nullptr && !cache->blocks[*cls].empty()) {
+        auto *ptr = cache->blocks[*cls].back();
+        cache->blocks[*cls].pop_back();
+        cached_bytes -= size;
+        ++hits;
+        return ptr;
+    }
+
+    {
+        std::lock_guard lock{mutex};
+        if (!shared[*cls].empty()) {
+            auto *ptr = shared[*cls].back();
+            shared[*cls].pop_back();
+            shared_bytes -= size;
+            cached_bytes -= size;
+            ++hits;
+            return ptr;
+        }
+    }
+
+    ++misses;
+    return types::malloc(size);
+}
+
+template <std::floating_point Real>
+void buffer_pool<Real>::deallocate(void *ptr, size_t bytes) noexcept {
+    using types = detail::fftw_types<Real>;
+    auto cls = size_class(bytes);
+    if (!cls) {
+        types::free(ptr);
+        return;
+    }
+    auto size = block_size(*cls);
+
+    if (auto *cache = local();
+        cache != nullptr && cache->blocks[*cls].size() < thread_cache_blocks) {
+        cache->blocks[*cls].push_back(ptr);
+        cached_bytes += size;
+        return;
+    }
+
+    {
+        std::lock_guard lock{mutex};
+        if (shared_bytes + size <= max_shared_bytes) {
+            try {
+                shared[*cls].push_back(ptr);
+                shared_bytes += size;
+                cached_bytes += size;
+                return;
+            } catch (const std::bad_alloc &) {
+                // fall through and release the block instead
+            }
+        }
+    }
+    types::free(ptr);
+}
+
+template <std::floating_point Real>
+void buffer_pool<Real>::release(free_lists &lists, bool is_shared) noexcept {
+    for (size_t cls = 0; cls < num_classes; ++cls) {
+        for (auto *ptr : lists[cls]) {
+            detail::fftw_types<Real>::free(ptr);
+            cached_bytes -= block_size(cls);
+            if (is_shared) { shared_bytes -= block_size(cls); }
+        }
+        lists[cls].clear();
+    }
+}
+
+template <std::floating_point Real> void buffer_pool<Real>::trim() {
+    if (auto *cache = local(); cache != nullptr) { release(cache->blocks, false); }
+    std::lock_guard lock{mutex};
+    release(shared, true);
+}
+
+template <std::floating_point Real> void buffer_pool<Real>::set_capacity(size_t bytes) {
+    std::lock_guard lock{mutex};
+    max_shared_bytes = bytes;
+    // release the largest blocks first until the free list fits
+    for (size_t cls = num_classes; cls-- > 0 && shared_bytes > max_shared_bytes;) {
+        while (!shared[cls].empty() && shared_bytes > max_shared_bytes) {
+            detail::fftw_types<Real>::free(shared[cls].back());
+            shared[cls].pop_back();
+            shared_bytes -= block_size(cls);
+            cached_bytes -= block_size(cls);
+        }
+    }
+}
+
+template <std::floating_point Real> size_t buffer_pool<Real>::capacity() const {
+    std::lock_guard lock{mutex};
+    return max_shared_bytes;
+}
+
+template <std::floating_point Real> buffer_pool_stats buffer_pool<Real>::stats() const {
+    std::lock_guard lock{mutex};
+    return {hits.load(), misses.load(), oversized.load(), cached_bytes.load(), shared_bytes};
+}
+
+} // namespace fftw
@@ -0,0 +1,211 @@
+#pragma once
+
+#include "basic_buffer.h"
+#include "basic_plan.h"
+#include "util.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <stdexcept>
+
+namespace fftw {
+
+/// How a streaming convolver splits the stream into FFT blocks.
+enum class convolution_method {
+    /// Each block re-reads the last kernel_size() - 1 input samples and discards the part of
+    /// the result that wrapped around. Needs no accumulation, usually the faster of the two.
+    OVERLAP_SAVE,
+    /// Each block transforms new input only, zero-padded, and the tails of consecutive results
+    /// are added up.
+    OVERLAP_ADD,
+};
+
+/// Streaming linear convolution of a real signal with a fixed FIR kernel.
+/// The kernel spectrum is computed once; every block then costs one r2c, one pointwise product
+/// and one c2r of fft_size() points, all on buffers allocated at construction, so push() never
+/// allocates.
+///
+/// push() accepts chunks of any length and returns exactly as many output samples, delayed by
+/// latency() samples: output sample i of the stream is sum_k kernel[k] * input[i - latency() - k].
+///
+/// \code
+/// fftw::convolver fir{taps};
+/// while (source.read(chunk)) {
+///     fir.push(chunk, filtered);
+///     sink.write(filtered);
+/// }
+/// \endcode
+template <class Real, class Complex = std::complex<Real>> class basic_convolver {
+  public:
+    using real_t = Real;
+    using complex_t = Complex;
+
+    /// Plans the transforms and computes the kernel spectrum.
+    /// An fft_size of 0 picks optimal_fft_size(kernel.size()).
+    explicit basic_convolver(std::span<const Real> kernel,
+                             convolution_method method = convolution_method::OVERLAP_SAVE,
+                             Flags flags = MEASURE, size_t fft_size = 0, int threads = 1);
+
+    /// The FFT size that minimizes the work per output sample for a kernel of this length,
+    /// among the sizes with only factors 2, 3, 5 and 7.
+    [[nodiscard]] static size_t optimal_fft_size(size_t kernel_size);
+
+    /// Filters input into output, which must have room for at least input.size() samples.
+    void push(std::span<const Real> input, std::span<Real> output);
+
+    /// Forgets the stream so far, as if the convolver was just constructed.
+    void reset();
+
+    [[nodiscard]] size_t kernel_size() const { return kernel_length; }
+    [[nodiscard]] size_t fft_size() const { return n; }
+    /// New input samples consumed by each FFT block.
+    [[nodiscard]] size_t block_size() const { return hop; }
+    /// Delay of the output relative to the input, in samples.
+    [[nodiscard]] size_t latency() const { return hop; }
+    [[nodiscard]] convolution_method method() const { return conv_method; }
+
+  private:
+    using rview = MDSPAN::mdspan<Real, MDSPAN::dextents<size_t, 1u>>;
+    using cview = MDSPAN::mdspan<Complex, MDSPAN::dextents<size_t, 1u>>;
+
+    /// Where new input goes in the FFT block.
+    [[nodiscard]] size_t input_offset() const {
+        return conv_method == convolution_method::OVERLAP_SAVE ? kernel_length - 1 : 0;
+    }
+
+    /// Convolves the full block and refills pending with the next block_size() output samples.
+    void process_block();
+
+    size_t kernel_length;
+    convolution_method conv_method;
+    size_t n;
+    size_t hop;
+    size_t filled{0}; ///< input samples in the current block, and output samples taken from pending
+
+    basic_rbuffer<Real, Complex> block;
+    basic_buffer<Real, Complex> spectrum;
+    basic_buffer<Real, Complex> kernel_spectrum;
+    basic_rbuffer<Real, Complex> result;
+    basic_rbuffer<Real, Complex> pending;
+    basic_rbuffer<Real, Complex> overlap; ///< running sum of block results, only for OVERLAP_ADD
+
+    basic_plan_r2c<1u, Real, Complex> forward;
+    basic_plan_c2r<1u, Real, Complex> backward;
+};
+
+template <class Real, class Complex>
+basic_convolver<Real, Complex>::basic_convolver(std::span<const Real> kernel,
+                                                convolution_method method, Flags flags,
+                                                size_t fft_size, int threads)
+    : kernel_length(kernel.size()), conv_method(method),
+      n(fft_size != 0 ? fft_size : optimal_fft_size(kernel.size())),
+      hop(n >= kernel_length ? n - kernel_length + 1 : 0), block(n), spectrum(n / 2 + 1),
+      kernel_spectrum(n / 2 + 1), result(n), pending(hop),
+      overlap(method == convolution_method::OVERLAP_ADD ? n : 0) {
+    if (kernel.empty()) { throw std::invalid_argument("empty convolution kernel"); }
+    if (n < kernel_length) {
+        throw std::invalid_argument("FFT size smaller than the convolution kernel");
+    }
+
+    rview block_view{block.data(), n}, result_view{result.data(), n};
+    cview spectrum_view{spectrum.data(), n / 2 + 1};
+    forward = basic_plan_r2c<1u, Real, Complex>::dft(block_view, spectrum_view, flags, threads);
+    backward = basic_plan_c2r<1u, Real, Complex>::dft(spectrum_view, result_view, flags, threads);
+
+    // The kernel spectrum includes the 1/n normalization of the inverse transform.
+    std::fill(block.begin(), block.end(), Real{0});
+    std::copy(kernel.begin(), kernel.end(), block.begin());
+    forward();
+    auto scale = Real{1} / Real(n);
+    for (size_t i = 0; i < kernel_spectrum.size(); ++i) {
+        kernel_spectrum[i] = spectrum[i] * scale;
+    }
+
+    reset();
+}
+
+template <class Real, class Complex>
+size_t basic_convolver<Real, Complex>::optimal_fft_size(size_t kernel_size) {
+    if (kernel_size == 0) { throw std::invalid_argument("empty convolution kernel"); }
+
+    // Work per output sample of one block: a forward and an inverse real FFT of about
+    // 2.5 n log2(n) flops each, plus the pointwise product of the half spectrum.
+    auto cost = [&](size_t size) {
+        auto flops = 5.0 * double(size) * std::log2(double(size)) + 3.0 * double(size);
+        return flops / double(size - kernel_size + 1);
+    };
+
+    // Larger blocks stop paying off long before 64 times the kernel length.
+    size_t limit = std::max<size_t>(64 * kernel_size, 64);
+    size_t best = 0;
+    double best_cost = std::numeric_limits<double>::infinity();
+    for (size_t p2 = 1; p2 <= limit; p2 *= 2) {
+        for (size_t p3 = p2; p3 <= limit; p3 *= 3) {
+            for (size_t p5 = p3; p5 <= limit; p5 *= 5) {
+                for (size_t p7 = p5; p7 <= limit; p7 *= 7) {
+                    if (p7 < kernel_size || p7 < 2) { continue; }
+                    if (auto c = cost(p7); c < best_cost) {
+                        best_cost = c;
+                        best = p7;
+                    }
+                }
+            }
+        }
+    }
+    return best;
+}
+
+template <class Real, class Complex>
+void basic_convolver<Real, Complex>::push(std::span<const Real> input, std::span<Real> output) {
+    if (output.size() < input.size()) {
+        throw std::invalid_argument("output shorter than input");
+    }
+
+    auto offset = input_offset();
+    size_t done = 0;
+    while (done < input.size()) {
+        auto count = std::min(input.size() - done, hop - filled);
+        std::copy_n(input.begin() + done, count, block.begin() + offset + filled);
+        std::copy_n(pending.begin() + filled, count, output.begin() + done);
+        filled += count;
+        done += count;
+
+        if (filled == hop) {
+            process_block();
+            filled = 0;
+        }
+    }
+}
+
+template <class Real, class Complex> void basic_convolver<Real, Complex>::reset() {
+    std::fill(block.begin(), block.end(), Real{0});
+    std::fill(pending.begin(), pending.end(), Real{0});
+    std::fill(overlap.begin(), overlap.end(), Real{0});
+    filled = 0;
+}
+
+template <class Real, class Complex> void basic_convolver<Real, Complex>::process_block() {
+    forward();
+    for (size_t i = 0; i < spectrum.size(); ++i) {
+        spectrum[i] *= kernel_spectrum[i];
+    }
+    backward();
+
+    if (conv_method == convolution_method::OVERLAP_SAVE) {
+        // The first kernel_size() - 1 results wrapped around; the rest is the output.
+        std::copy_n(result.begin() + (kernel_length - 1), hop, pending.begin());
+        // Keep the last kernel_size() - 1 inputs for the next block.
+        std::copy(block.end() - (kernel_length - 1), block.end(), block.begin());
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            overlap[i] += result[i];
+        }
+        std::copy_n(overlap.begin(), hop, pending.begin());
+        std::copy(overlap.begin() + hop, overlap.end(), overlap.begin());
+        std::fill(overlap.end() - hop, overlap.end(), Real{0});
+    }
+}
+
+} // namespace fftw
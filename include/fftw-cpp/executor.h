@@ -0,0 +1,274 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace fftw {
+
+/// The exception a cancelled job completes with.
+class job_cancelled : public std::runtime_error {
+  public:
+    job_cancelled() : std::runtime_error("fftw job cancelled") {}
+};
+
+namespace detail {
+
+struct job_state {
+    enum class status { QUEUED, RUNNING, DONE, CANCELLED };
+
+    explicit job_state(std::function<void()> work)
+        : work(std::move(work)), future(promise.get_future().share()) {}
+
+    /// Completes the job and returns the coroutine waiting for it, if any.
+    std::coroutine_handle<> finish(status final_status, std::exception_ptr error) {
+        std::lock_guard lock{mutex};
+        current = final_status;
+        if (error) {
+            promise.set_exception(error);
+        } else {
+            promise.set_value();
+        }
+        work = nullptr;
+        return std::exchange(continuation, nullptr);
+    }
+
+    std::mutex mutex;
+    status current{status::QUEUED};
+    std::function<void()> work;
+    std::promise<void> promise;
+    std::shared_future<void> future;
+    std::coroutine_handle<> continuation;
+};
+
+} // namespace detail
+
+/// A transform submitted to an executor.
+/// Wait for it with wait() or get(), through its future(), or by co_await-ing it in a coroutine,
+/// which is resumed on the worker thread that finished the job.
+class job {
+  public:
+    job() = default;
+
+    /// Cancels the job if it has not started yet; it then completes with job_cancelled.
+    /// Returns whether the job was cancelled; a running job is never interrupted.
+    bool cancel() {
+        {
+            std::lock_guard lock{state->mutex};
+            if (state->current != detail::job_state::status::QUEUED) { return false; }
+            state->current = detail::job_state::status::CANCELLED;
+        }
+        auto continuation = state->finish(detail::job_state::status::CANCELLED,
+                                          std::make_exception_ptr(job_cancelled{}));
+        if (continuation) { continuation.resume(); }
+        return true;
+    }
+
+    /// Blocks until the job has finished or was cancelled.
+    void wait() const { state->future.wait(); }
+
+    /// Blocks until the job has finished, and rethrows its exception (or job_cancelled).
+    void get() const { state->future.get(); }
+
+    [[nodiscard]] bool done() const {
+        return state->future.wait_for(std::chrono::seconds{0}) == std::future_status::ready;
+    }
+
+    [[nodiscard]] std::shared_future<void> future() const { return state->future; }
+
+    [[nodiscard]] bool valid() const { return state != nullptr; }
+
+    auto operator co_await() const {
+        struct awaiter {
+            std::shared_ptr<detail::job_state> state;
+
+            bool await_ready() const {
+                return state->future.wait_for(std::chrono::seconds{0}) ==
+                       std::future_status::ready;
+            }
+            bool await_suspend(std::coroutine_handle<> handle) const {
+                std::lock_guard lock{state->mutex};
+                using status = detail::job_state::status;
+                if (state->current == status::DONE || state->current == status::CANCELLED) {
+                    return false;
+                }
+                state->continuation = handle;
+                return true;
+            }
+            void await_resume() const { state->future.get(); }
+        };
+        return awaiter{state};
+    }
+
+  private:
+    friend class executor;
+    explicit job(std::shared_ptr<detail::job_state> state) : state(std::move(state)) {}
+
+    std::shared_ptr<detail::job_state> state;
+};
+
+/// A pool of worker threads that execute plans asynchronously.
+/// FFTW's new-array execute functions are thread-safe, so one plan may run on several workers at
+/// once, as long as every job has its own arrays. The executor never plans or destroys plans;
+/// the plans and arrays of a job must outlive it.
+///
+/// \code
+/// fftw::executor pool{4};
+/// auto done = pool.submit(plan, in_view, out_view);
+/// load_next_block();
+/// done.get();
+/// \endcode
+class executor {
+  public:
+    /// Starts `workers` threads; 0 uses the number of hardware threads.
+    explicit executor(size_t workers = 0) {
+        if (workers == 0) { workers = std::max(1u, std::thread::hardware_concurrency()); }
+        threads.reserve(workers);
+        for (size_t i = 0; i < workers; ++i) {
+            threads.emplace_back([this] { run(); });
+        }
+    }
+
+    executor(const executor &) = delete;
+    executor &operator=(const executor &) = delete;
+
+    /// Finishes all queued jobs, then stops the workers.
+    ~executor() {
+        {
+            std::lock_guard lock{mutex};
+            stopping = true;
+        }
+        wakeup.notify_all();
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    }
+
+    /// Queues plan(args...), e.g. a new-array execution plan(in, out) or plan() itself.
+    /// Arguments passed as lvalues (e.g. buffers) are used by reference, others (e.g. views)
+    /// are copied into the job.
+    template <typename Plan, typename... Args> job submit(const Plan &plan, Args &&...args) {
+        auto state = make_state(plan, std::forward<Args>(args)...);
+        {
+            std::lock_guard lock{mutex};
+            if (stopping) { throw std::runtime_error("executor is shutting down"); }
+            queue.push_back(state);
+        }
+        wakeup.notify_one();
+        return job{std::move(state)};
+    }
+
+    /// Queues plan(in, out) for every pair of elements of the two ranges, under a single lock.
+    template <typename Plan, std::ranges::forward_range Ins, std::ranges::forward_range Outs>
+    std::vector<job> submit_batch(const Plan &plan, Ins &ins, Outs &outs) {
+        if (std::ranges::distance(ins) != std::ranges::distance(outs)) {
+            throw std::invalid_argument("batch sizes don't match");
+        }
+
+        std::vector<job> jobs;
+        jobs.reserve(size_t(std::ranges::distance(ins)));
+        auto out = std::ranges::begin(outs);
+        for (auto &in : ins) {
+            jobs.push_back(job{make_state(plan, in, *out)});
+            ++out;
+        }
+        {
+            std::lock_guard lock{mutex};
+            if (stopping) { throw std::runtime_error("executor is shutting down"); }
+            for (auto &j : jobs) {
+                queue.push_back(j.state);
+            }
+        }
+        wakeup.notify_all();
+        return jobs;
+    }
+
+    /// Cancels every job that has not started yet. Returns how many were cancelled.
+    size_t cancel_all() {
+        std::deque<std::shared_ptr<detail::job_state>> pending;
+        {
+            std::lock_guard lock{mutex};
+            pending.swap(queue);
+        }
+        size_t cancelled = 0;
+        for (auto &state : pending) {
+            cancelled += job{std::move(state)}.cancel() ? 1 : 0;
+        }
+        return cancelled;
+    }
+
+    /// Blocks until every job is finished or cancelled; rethrows the first failure, if any.
+    static void wait_all(const std::vector<job> &jobs) {
+        for (const auto &j : jobs) {
+            j.wait();
+        }
+        for (const auto &j : jobs) {
+            j.get();
+        }
+    }
+
+    /// The number of worker threads.
+    [[nodiscard]] size_t size() const { return threads.size(); }
+
+  private:
+    template <typename Plan, typename... Args>
+    static std::shared_ptr<detail::job_state> make_state(const Plan &plan, Args &&...args) {
+        return std::make_shared<detail::job_state>(
+            [&plan, args = std::tuple<Args...>(std::forward<Args>(args)...)]() mutable {
+                std::apply(plan, args);
+            });
+    }
+
+    void run() {
+        using status = detail::job_state::status;
+        while (true) {
+            std::shared_ptr<detail::job_state> state;
+            {
+                std::unique_lock lock{mutex};
+                wakeup.wait(lock, [this] { return stopping || !queue.empty(); });
+                if (queue.empty()) { return; }
+                state = std::move(queue.front());
+                queue.pop_front();
+            }
+
+            std::function<void()> work;
+            {
+                std::lock_guard lock{state->mutex};
+                if (state->current != status::QUEUED) { continue; } // cancelled meanwhile
+                state->current = status::RUNNING;
+                work = std::move(state->work);
+            }
+
+            std::exception_ptr error;
+            try {
+                work();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            if (auto continuation = state->finish(status::DONE, error)) { continuation.resume(); }
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::deque<std::shared_ptr<detail::job_state>> queue;
+    bool stopping{false};
+    std::vector<std::thread> threads;
+};
+
+} // namespace fftw
@@ -5,8 +5,29 @@
 #include <complex>
 #include <fftw3.h>
 
+#include "basic_batched_plan.h"
 #include "basic_buffer.h"
 #include "basic_plan.h"
+#include "basic_plan_r2r.h"
+#include "buffer_pool.h"
+#include "convolver.h"
+#include "executor.h"
+#include "hermitian.h"
+#include "instrumentation.h"
+#include "layout_r2c_padded.h"
+#if __has_include(<sys/mman.h>)
+#include "mapped_buffer.h"
+#include "out_of_core.h"
+#endif
+#ifdef FFTW_CPP_MPI
+#include "mpi.h"
+#endif
+#include "plan_cache.h"
+#include "spectral_pipeline.h"
+#include "static_plan.h"
+#include "stft.h"
+#include "upgradable_plan.h"
+#include "wisdom.h"
 
 namespace fftw {
 
@@ -25,14 +46,109 @@ template <size_t D = 1u> using plan_r2c = basic_plan_r2c<D, double>;
 
 template <size_t D = 1u> using plan_c2r = basic_plan_c2r<D, double>;
 
+template <size_t D = 1u> using plan_r2r = basic_plan_r2r<D, double>;
+
+template <size_t D = 1u> using batched_plan = basic_batched_plan<D, double>;
+
+template <size_t D = 1u> using batched_plan_r2c = basic_batched_plan_r2c<D, double>;
+
+template <size_t D = 1u> using batched_plan_c2r = basic_batched_plan_c2r<D, double>;
+
 using buffer = basic_buffer<double>;
 using rbuffer = basic_rbuffer<double>;
+using buffer_view = basic_buffer_view<double>;
+using rbuffer_view = basic_rbuffer_view<double>;
 
 template <size_t D, typename Layout = MDSPAN::layout_right, bool IsReal = false>
 using mdbuffer = basic_mdbuffer<double, dextents<size_t, D>, std::complex<double>, Layout, IsReal>;
 
 template <size_t D, typename Layout = MDSPAN::layout_right>
 using rmdbuffer = mdbuffer<D, Layout, true>;
+
+/// Storage for in-place real transforms, see layout_r2c_padded.
+template <size_t D> using padded_mdbuffer = basic_padded_mdbuffer<double, dextents<size_t, D>>;
+
+using convolver = basic_convolver<double>;
+using stft = basic_stft<double>;
+
+template <size_t D = 1u> using spectral_pipeline = basic_spectral_pipeline<D, double>;
+
+/// Compile-time size transforms, see basic_static_plan.
+template <size_t N> using static_plan = basic_static_plan<N, double>;
+template <typename View> using static_dft_plan = basic_static_dft_plan<View, double>;
+
+/// Buffers drawing from buffer_pool<double>, for scratch buffers that are created often.
+using pooled_buffer = basic_buffer<double, std::complex<double>, false, pool_allocator<double>>;
+using pooled_rbuffer = basic_rbuffer<double, std::complex<double>, pool_allocator<double>>;
+
+template <size_t D, typename Layout = MDSPAN::layout_right, bool IsReal = false>
+using pooled_mdbuffer = basic_mdbuffer<double, dextents<size_t, D>, std::complex<double>, Layout,
+                                       IsReal, pool_allocator<double>>;
+
+template <size_t D, typename Layout = MDSPAN::layout_right>
+using pooled_rmdbuffer = pooled_mdbuffer<D, Layout, true>;
+
+#if __has_include(<sys/mman.h>)
+/// Buffers backed by huge pages, for large grids.
+using huge_buffer = basic_buffer<double, std::complex<double>, false, hugepage_allocator<double>>;
+using huge_rbuffer = basic_rbuffer<double, std::complex<double>, hugepage_allocator<double>>;
+
+template <size_t D, typename Layout = MDSPAN::layout_right, bool IsReal = false>
+using huge_mdbuffer = basic_mdbuffer<double, dextents<size_t, D>, std::complex<double>, Layout,
+                                     IsReal, hugepage_allocator<double>>;
+
+template <size_t D, typename Layout = MDSPAN::layout_right>
+using huge_rmdbuffer = huge_mdbuffer<D, Layout, true>;
+
+/// Files mapped into memory, see basic_mapped_file.
+using mapped_file = basic_mapped_file<double>;
+using rmapped_file = basic_rmapped_file<double>;
+
+using out_of_core_fft = basic_out_of_core_fft<double>;
+#endif
+
+#ifdef FFTW_CPP_MPI
+/// Distributed transforms, see basic_mpi_plan.
+template <size_t D = 2u> using mpi_plan = basic_mpi_plan<D, double>;
+
+template <size_t D = 2u> using mpi_plan_r2c = basic_mpi_plan_r2c<D, double>;
+
+template <size_t D = 2u> using mpi_plan_c2r = basic_mpi_plan_c2r<D, double>;
+
+using mpi_guard = basic_mpi_guard<double>;
+#endif
+/// @}
+
+/// \defgroup Single-precision convenience types (require FFTW_CPP_FLOAT)
+/// @{
+template <size_t D = 1u> using fplan = basic_plan<D, float>;
+
+template <size_t D = 1u> using fplan_r2c = basic_plan_r2c<D, float>;
+
+template <size_t D = 1u> using fplan_c2r = basic_plan_c2r<D, float>;
+
+template <size_t D = 1u> using fplan_r2r = basic_plan_r2r<D, float>;
+
+using fbuffer = basic_buffer<float>;
+using frbuffer = basic_rbuffer<float>;
+using fbuffer_view = basic_buffer_view<float>;
+using frbuffer_view = basic_rbuffer_view<float>;
+
+template <size_t D, typename Layout = MDSPAN::layout_right, bool IsReal = false>
+using fmdbuffer = basic_mdbuffer<float, dextents<size_t, D>, std::complex<float>, Layout, IsReal>;
+
+template <size_t D, typename Layout = MDSPAN::layout_right>
+using frmdbuffer = fmdbuffer<D, Layout, true>;
+
+using fconvolver = basic_convolver<float>;
+using fstft = basic_stft<float>;
+
+template <size_t D = 1u> using fspectral_pipeline = basic_spectral_pipeline<D, float>;
+
+template <size_t N> using fstatic_plan = basic_static_plan<N, float>;
+template <typename View> using fstatic_dft_plan = basic_static_dft_plan<View, float>;
+
+template <size_t D> using fpadded_mdbuffer = basic_padded_mdbuffer<float, dextents<size_t, D>>;
 /// @}
 
 } // namespace fftw
\ No newline at end of file
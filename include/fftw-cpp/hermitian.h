@@ -0,0 +1,229 @@
+#pragma once
+
+#include "basic_plan.h"
+#include "util.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <future>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace fftw {
+
+/// \defgroup{Hermitian spectra}
+/// The r2c transform of real data is Hermitian, X[k] == conj(X[-k]) with every index taken modulo
+/// its extent, so basic_plan_r2c only computes the half spectrum: the last dimension in FFTW order
+/// has n / 2 + 1 elements. These helpers convert between half and full spectra and compute
+/// per-bin power, magnitude and phase.
+///
+/// They take the same views as basic_plan_r2c: layout_right, layout_left (whose last dimension in
+/// FFTW order is the first mdspan extent), layout_stride and layout_r2c_padded, or mdbuffers.
+/// The work is done row by row along the last FFTW dimension in segments of a few thousand
+/// elements; rows with unit stride are plain loops the compiler vectorizes. With threads > 1,
+/// the segments are split between the calling thread and threads - 1 tasks.
+
+namespace detail {
+
+/// Elements per unit of work of the Hermitian helpers.
+inline constexpr size_t hermitian_segment = 4096;
+
+/// Offset of row k (an FFTW-order index without its last dimension) in a view, in elements.
+template <size_t D, typename View>
+size_t row_offset(const View &view, const std::array<size_t, D> &k) {
+    size_t offset = 0;
+    for (size_t j = 0; j + 1 < D; ++j) {
+        offset += k[j] * size_t(view.stride(fftw_index<View>(j)));
+    }
+    return offset;
+}
+
+template <size_t D, typename View> size_t last_stride(const View &view) {
+    return size_t(view.stride(fftw_index<View>(D - 1)));
+}
+
+/// Calls f(k, begin, end) for every row k of an array with FFTW-order extents n and every
+/// segment [begin, end) of the last dimension, of length cols (which may differ from n[D - 1]).
+template <size_t D, typename F>
+void for_each_segment(const std::array<int, D> &n, size_t cols, int threads, F f) {
+    size_t rows = 1;
+    for (size_t j = 0; j + 1 < D; ++j) {
+        rows *= size_t(n[j]);
+    }
+    size_t segments_per_row =
+        std::max<size_t>(1, (cols + hermitian_segment - 1) / hermitian_segment);
+    size_t work = rows * segments_per_row;
+    if (work == 0) { return; }
+
+    auto run = [&](size_t first, size_t last) {
+        std::array<size_t, D> k{};
+        for (size_t w = first; w < last; ++w) {
+            size_t row = w / segments_per_row, segment = w % segments_per_row;
+            for (size_t j = D - 1; j-- > 0;) {
+                k[j] = row % size_t(n[j]);
+                row /= size_t(n[j]);
+            }
+            size_t begin = segment * hermitian_segment;
+            f(k, begin, std::min(cols, begin + hermitian_segment));
+        }
+    };
+
+    size_t parts = std::clamp<size_t>(size_t(std::max(threads, 1)), 1, work);
+    std::vector<std::future<void>> tasks;
+    for (size_t p = 1; p < parts; ++p) {
+        tasks.push_back(std::async(std::launch::async, run, p * work / parts,
+                                   (p + 1) * work / parts));
+    }
+    run(0, work / parts);
+    for (auto &task : tasks) {
+        task.get();
+    }
+}
+
+/// Applies f(in_element, out_element...) to matching elements of views with the same FFTW-order
+/// extents.
+template <size_t D, typename F, typename In, typename... Out>
+void map_spectrum(const In &in, int threads, F f, const Out &...out) {
+    auto n = fftw_extents<D>(in);
+    if (((fftw_extents<D>(out) != n) || ...)) {
+        throw std::invalid_argument("Extents don't match");
+    }
+
+    for_each_segment<D>(n, size_t(n[D - 1]), threads, [&](const auto &k, size_t begin, size_t end) {
+        auto *x = in.data_handle() + row_offset<D>(in, k);
+        auto xs = last_stride<D>(in);
+        auto apply = [&](auto... y) {
+            if (xs == 1 && ((last_stride<D>(out) == 1) && ...)) {
+                for (size_t i = begin; i < end; ++i) {
+                    f(x[i], y[i]...);
+                }
+            } else {
+                for (size_t i = begin; i < end; ++i) {
+                    f(x[i * xs], y[i * last_stride<D>(out)]...);
+                }
+            }
+        };
+        apply(out.data_handle() + row_offset<D>(out, k)...);
+    });
+}
+
+template <typename View> constexpr size_t rank_of() {
+    return decltype(as_view(std::declval<std::remove_cvref_t<View> &>()))::rank();
+}
+
+} // namespace detail
+
+/// Writes the full spectrum of a real transform, given its half spectrum. The extents of full
+/// are those of the real data; they determine whether the last FFTW dimension is even or odd.
+template <typename Half, typename Full>
+void expand_half_spectrum(Half &&half, Full &&full, int threads = 1) {
+    constexpr size_t D = detail::rank_of<Half>();
+    auto h = detail::as_view(half);
+    auto f = detail::as_view(full);
+    if (h.size() != 0 &&
+        static_cast<const void *>(h.data_handle()) == static_cast<const void *>(f.data_handle())) {
+        throw std::invalid_argument("The half and the full spectrum must not overlap");
+    }
+    auto n = detail::dims_r2c<D>(f, h);
+    size_t half_cols = size_t(n[D - 1]) / 2 + 1;
+
+    auto expand_segment = [&](const auto &k, size_t begin, size_t end) {
+        // the mirrored row, -k modulo the extents, holds the conjugates of the upper half
+        std::array<size_t, D> mirror{};
+        for (size_t j = 0; j + 1 < D; ++j) {
+            mirror[j] = k[j] == 0 ? 0 : size_t(n[j]) - k[j];
+        }
+        auto *out = f.data_handle() + detail::row_offset<D>(f, k);
+        const auto *same = h.data_handle() + detail::row_offset<D>(h, k);
+        const auto *conj = h.data_handle() + detail::row_offset<D>(h, mirror);
+        auto os = detail::last_stride<D>(f), hs = detail::last_stride<D>(h);
+        size_t split = std::clamp(half_cols, begin, end);
+
+        if (os == 1 && hs == 1) {
+            std::copy(same + begin, same + split, out + begin);
+            for (size_t i = split; i < end; ++i) {
+                out[i] = std::conj(conj[size_t(n[D - 1]) - i]);
+            }
+        } else {
+            for (size_t i = begin; i < split; ++i) {
+                out[i * os] = same[i * hs];
+            }
+            for (size_t i = split; i < end; ++i) {
+                out[i * os] = std::conj(conj[(size_t(n[D - 1]) - i) * hs]);
+            }
+        }
+    };
+    detail::for_each_segment<D>(n, size_t(n[D - 1]), threads, expand_segment);
+}
+
+/// Writes the half spectrum (what basic_plan_r2c computes) of a full Hermitian spectrum, e.g. to
+/// go back to c2r from a consumer that works on full spectra.
+template <typename Full, typename Half>
+void extract_half_spectrum(Full &&full, Half &&half, int threads = 1) {
+    constexpr size_t D = detail::rank_of<Half>();
+    auto h = detail::as_view(half);
+    auto f = detail::as_view(full);
+    if (h.size() != 0 &&
+        static_cast<const void *>(h.data_handle()) == static_cast<const void *>(f.data_handle())) {
+        throw std::invalid_argument("The half and the full spectrum must not overlap");
+    }
+    auto n = detail::dims_r2c<D>(f, h);
+
+    auto copy_segment = [&](const auto &k, size_t begin, size_t end) {
+        const auto *in = f.data_handle() + detail::row_offset<D>(f, k);
+        auto *out = h.data_handle() + detail::row_offset<D>(h, k);
+        auto is = detail::last_stride<D>(f), os = detail::last_stride<D>(h);
+        for (size_t i = begin; i < end; ++i) {
+            out[i * os] = in[i * is];
+        }
+    };
+    detail::for_each_segment<D>(n, size_t(n[D - 1]) / 2 + 1, threads, copy_segment);
+}
+
+/// Writes |X|^2 of every bin of a (half) spectrum into a real array of the same extents.
+template <typename Spectrum, typename Out>
+void power_spectrum(Spectrum &&spectrum, Out &&power, int threads = 1) {
+    constexpr size_t D = detail::rank_of<Spectrum>();
+    detail::map_spectrum<D>(
+        detail::as_view(spectrum), threads,
+        [](const auto &x, auto &p) { p = x.real() * x.real() + x.imag() * x.imag(); },
+        detail::as_view(power));
+}
+
+/// Writes |X| of every bin. Computed as sqrt(re^2 + im^2), which vectorizes, unlike std::abs.
+template <typename Spectrum, typename Out>
+void magnitude_spectrum(Spectrum &&spectrum, Out &&magnitude, int threads = 1) {
+    constexpr size_t D = detail::rank_of<Spectrum>();
+    detail::map_spectrum<D>(
+        detail::as_view(spectrum), threads,
+        [](const auto &x, auto &m) { m = std::sqrt(x.real() * x.real() + x.imag() * x.imag()); },
+        detail::as_view(magnitude));
+}
+
+/// Writes arg(X), in (-pi, pi], of every bin.
+template <typename Spectrum, typename Out>
+void phase_spectrum(Spectrum &&spectrum, Out &&phase, int threads = 1) {
+    constexpr size_t D = detail::rank_of<Spectrum>();
+    detail::map_spectrum<D>(
+        detail::as_view(spectrum), threads,
+        [](const auto &x, auto &a) { a = std::atan2(x.imag(), x.real()); },
+        detail::as_view(phase));
+}
+
+/// Writes magnitude and phase of every bin in one pass over the spectrum.
+template <typename Spectrum, typename Magnitude, typename Phase>
+void polar_spectrum(Spectrum &&spectrum, Magnitude &&magnitude, Phase &&phase, int threads = 1) {
+    constexpr size_t D = detail::rank_of<Spectrum>();
+    detail::map_spectrum<D>(
+        detail::as_view(spectrum), threads,
+        [](const auto &x, auto &m, auto &a) {
+            m = std::sqrt(x.real() * x.real() + x.imag() * x.imag());
+            a = std::atan2(x.imag(), x.real());
+        },
+        detail::as_view(magnitude), detail::as_view(phase));
+}
+
+} // namespace fftw
@@ -0,0 +1,211 @@
+#pragma once
+
+#include "util.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fftw {
+
+/// Execution metrics of one instrumented plan, see plan_base::instrument().
+struct execution_stats {
+    /// Latency histogram size: bucket i counts executions that took less than 2^i microseconds,
+    /// the last bucket also everything slower.
+    static constexpr size_t buckets = 24;
+
+    std::string name;  ///< the name passed to instrument()
+    std::string plan;  ///< the algorithm chosen by the planner (fftw_sprint_plan)
+    double flops{0.0}; ///< floating-point operations per execution (see plan_base::flops())
+    size_t calls{0};
+    double total_seconds{0.0};
+    double min_seconds{0.0};
+    double max_seconds{0.0};
+    std::array<size_t, buckets> histogram{};
+
+    [[nodiscard]] double mean_seconds() const {
+        return calls > 0 ? total_seconds / double(calls) : 0.0;
+    }
+
+    /// Achieved GFLOP/s (10^9 operations per second) over all executions.
+    [[nodiscard]] double gflops() const {
+        return total_seconds > 0.0 ? flops * double(calls) / total_seconds / 1e9 : 0.0;
+    }
+};
+
+namespace detail {
+
+/// Metrics of one plan, shared between the plan and the registry so they outlive the plan.
+class plan_metrics {
+  public:
+    plan_metrics(std::string name, std::string plan, double flops) {
+        stats.name = std::move(name);
+        stats.plan = std::move(plan);
+        stats.flops = flops;
+    }
+
+    void record(double seconds) {
+        size_t bucket = 0;
+        for (double bound = 1e-6; bucket + 1 < execution_stats::buckets && seconds >= bound;
+             bound *= 2.0) {
+            ++bucket;
+        }
+
+        std::lock_guard lock{mutex};
+        stats.min_seconds = stats.calls == 0 ? seconds : std::min(stats.min_seconds, seconds);
+        stats.max_seconds = std::max(stats.max_seconds, seconds);
+        stats.total_seconds += seconds;
+        ++stats.calls;
+        ++stats.histogram[bucket];
+    }
+
+    [[nodiscard]] execution_stats snapshot() const {
+        std::lock_guard lock{mutex};
+        return stats;
+    }
+
+    void reset() {
+        std::lock_guard lock{mutex};
+        stats.calls = 0;
+        stats.total_seconds = stats.min_seconds = stats.max_seconds = 0.0;
+        stats.histogram = {};
+    }
+
+  private:
+    mutable std::mutex mutex;
+    execution_stats stats;
+};
+
+/// Every plan instrumented in this process, in order of instrumentation.
+class metrics_registry {
+  public:
+    static metrics_registry &instance() {
+        static metrics_registry registry;
+        return registry;
+    }
+
+    void add(std::shared_ptr<plan_metrics> metrics) {
+        std::lock_guard lock{mutex};
+        all.push_back(std::move(metrics));
+    }
+
+    [[nodiscard]] std::vector<std::shared_ptr<plan_metrics>> metrics() const {
+        std::lock_guard lock{mutex};
+        return all;
+    }
+
+    void clear() {
+        std::lock_guard lock{mutex};
+        all.clear();
+    }
+
+  private:
+    mutable std::mutex mutex;
+    std::vector<std::shared_ptr<plan_metrics>> all;
+};
+
+/// Times one execution of an instrumented plan; does nothing for plans without metrics.
+class execution_timer {
+  public:
+    explicit execution_timer(plan_metrics *metrics) : metrics(metrics) {
+        if (metrics != nullptr) { start = std::chrono::steady_clock::now(); }
+    }
+
+    execution_timer(const execution_timer &) = delete;
+    execution_timer &operator=(const execution_timer &) = delete;
+
+    ~execution_timer() {
+        if (metrics != nullptr) {
+            metrics->record(
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+    }
+
+  private:
+    plan_metrics *metrics;
+    std::chrono::steady_clock::time_point start{};
+};
+
+inline void write_json_string(std::ostream &os, const std::string &s) {
+    os << '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            os << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", unsigned(c));
+            os << escaped;
+        } else {
+            os << c;
+        }
+    }
+    os << '"';
+}
+
+} // namespace detail
+
+/// Metrics of every instrumented plan, in order of instrumentation. Metrics outlive their plans.
+inline std::vector<execution_stats> instrumentation_snapshot() {
+    std::vector<execution_stats> result;
+    for (const auto &metrics : detail::metrics_registry::instance().metrics()) {
+        result.push_back(metrics->snapshot());
+    }
+    return result;
+}
+
+/// Zeroes the counters of every instrumented plan, e.g. after a warm-up phase.
+inline void reset_instrumentation() {
+    for (const auto &metrics : detail::metrics_registry::instance().metrics()) {
+        metrics->reset();
+    }
+}
+
+/// Forgets the metrics of every instrumented plan. Live plans keep recording, but are no longer
+/// reported.
+inline void clear_instrumentation() { detail::metrics_registry::instance().clear(); }
+
+/// Writes instrumentation_snapshot() as a JSON array with one object per plan. Histogram entry i
+/// counts executions shorter than 2^i microseconds (see execution_stats::buckets).
+inline void write_instrumentation_json(std::ostream &os) {
+    auto flags = os.flags();
+    auto precision = os.precision(9);
+    os << '[';
+    bool first = true;
+    for (const auto &stats : instrumentation_snapshot()) {
+        os << (first ? "\n  {" : ",\n  {");
+        first = false;
+        os << "\"name\": ";
+        detail::write_json_string(os, stats.name);
+        os << ", \"plan\": ";
+        detail::write_json_string(os, stats.plan);
+        os << ", \"flops\": " << stats.flops << ", \"calls\": " << stats.calls
+           << ", \"total_seconds\": " << stats.total_seconds
+           << ", \"mean_seconds\": " << stats.mean_seconds()
+           << ", \"min_seconds\": " << stats.min_seconds
+           << ", \"max_seconds\": " << stats.max_seconds << ", \"gflops\": " << stats.gflops()
+           << ", \"histogram\": [";
+        for (size_t i = 0; i < stats.histogram.size(); ++i) {
+            os << (i == 0 ? "" : ", ") << stats.histogram[i];
+        }
+        os << "]}";
+    }
+    os << (first ? "]" : "\n]") << '\n';
+    os.precision(precision);
+    os.flags(flags);
+}
+
+inline std::string instrumentation_json() {
+    std::ostringstream os;
+    write_instrumentation_json(os);
+    return os.str();
+}
+
+} // namespace fftw
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "basic_buffer.h"
+#include "include_mdspan.h"
+#include "util.h"
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+namespace fftw {
+
+/// Row-major layout whose last dimension is padded to 2 * (n / 2 + 1) elements.
+/// This is the layout FFTW expects for the real array of an in-place r2c or c2r transform: a real
+/// view with this layout and a layout_right complex view of the half spectrum cover exactly the
+/// same memory. basic_padded_mdbuffer allocates such storage and provides both views.
+struct layout_r2c_padded {
+    template <class Extents> class mapping {
+        static_assert(Extents::rank() >= 1u, "the padded layout needs at least one dimension");
+
+      public:
+        using extents_type = Extents;
+        using index_type = typename Extents::index_type;
+        using size_type = typename Extents::size_type;
+        using rank_type = typename Extents::rank_type;
+        using layout_type = layout_r2c_padded;
+
+        constexpr mapping() noexcept = default;
+        constexpr mapping(const extents_type &extents) noexcept : ext(extents) {}
+
+        constexpr const extents_type &extents() const noexcept { return ext; }
+
+        /// The length of the last dimension including the padding.
+        constexpr index_type padded_extent() const noexcept {
+            return 2 * (ext.extent(Extents::rank() - 1) / 2 + 1);
+        }
+
+        constexpr index_type stride(rank_type r) const noexcept {
+            if (r + 1 == Extents::rank()) { return 1; }
+            index_type s = padded_extent();
+            for (rank_type i = r + 1; i + 1 < Extents::rank(); ++i) {
+                s *= ext.extent(i);
+            }
+            return s;
+        }
+
+        template <class... Indices>
+            requires(sizeof...(Indices) == Extents::rank() &&
+                     (std::is_convertible_v<Indices, index_type> && ...))
+        constexpr index_type operator()(Indices... indices) const noexcept {
+            std::array<index_type, Extents::rank()> idx{index_type(indices)...};
+            index_type offset = 0;
+            for (rank_type r = 0; r < Extents::rank(); ++r) {
+                offset += idx[r] * stride(r);
+            }
+            return offset;
+        }
+
+        constexpr index_type required_span_size() const noexcept {
+            index_type size = padded_extent();
+            for (rank_type r = 0; r + 1 < Extents::rank(); ++r) {
+                size *= ext.extent(r);
+            }
+            return size;
+        }
+
+        static constexpr bool is_always_unique() noexcept { return true; }
+        static constexpr bool is_always_exhaustive() noexcept { return false; }
+        static constexpr bool is_always_strided() noexcept { return true; }
+        static constexpr bool is_unique() noexcept { return true; }
+        constexpr bool is_exhaustive() const noexcept { return false; }
+        static constexpr bool is_strided() noexcept { return true; }
+
+        friend constexpr bool operator==(const mapping &a, const mapping &b) noexcept {
+            return a.ext == b.ext;
+        }
+
+      private:
+        extents_type ext{};
+    };
+};
+
+/// Storage for an in-place real transform of the given (real) extents.
+/// The same memory is viewed as a padded real array with to_real_mdspan() and as the complex half
+/// spectrum with to_complex_mdspan(), so an r2c or c2r plan between the two views needs no second
+/// buffer.
+///
+/// \code
+/// fftw::padded_mdbuffer<2> field{ny, nx};
+/// auto p = fftw::plan_r2c<2>::dft(field.to_real_mdspan(), field.to_complex_mdspan(), flags);
+/// \endcode
+template <typename Real, typename Extents, typename Complex = std::complex<Real>,
+          class Storage = fftw_allocator<Real>>
+class basic_padded_mdbuffer {
+  public:
+    using extents_type = Extents;
+    using index_type = typename Extents::index_type;
+    using real_mdspan_type = MDSPAN::mdspan<Real, Extents, layout_r2c_padded>;
+    using complex_extents_type = MDSPAN::dextents<index_type, Extents::rank()>;
+    using complex_mdspan_type = MDSPAN::mdspan<Complex, complex_extents_type, MDSPAN::layout_right>;
+
+    explicit basic_padded_mdbuffer(const Extents &extents)
+        : real_mapping(extents), storage(real_mapping.required_span_size() / 2) {}
+
+    template <class... Indices>
+        requires(sizeof...(Indices) == Extents::rank_dynamic() && sizeof...(Indices) > 0)
+    explicit basic_padded_mdbuffer(Indices... extents)
+        : basic_padded_mdbuffer(Extents(index_type(extents)...)) {}
+
+    /// The real extents, without padding.
+    const Extents &extents() const { return real_mapping.extents(); }
+    index_type extent(size_t r) const { return extents().extent(r); }
+
+    /// The real array, including the unused padding at the end of each row.
+    real_mdspan_type to_real_mdspan() {
+        return real_mdspan_type{reinterpret_cast<Real *>(storage.data()), real_mapping};
+    }
+
+    /// The complex half spectrum: the last extent is n / 2 + 1.
+    complex_mdspan_type to_complex_mdspan() {
+        std::array<index_type, Extents::rank()> n{};
+        for (size_t r = 0; r < Extents::rank(); ++r) {
+            n[r] = extent(r);
+        }
+        n.back() = real_mapping.padded_extent() / 2;
+        return complex_mdspan_type{storage.data(), complex_extents_type{n}};
+    }
+
+    Complex *data() { return storage.data(); }
+    const Complex *data() const { return storage.data(); }
+
+    /// The number of complex elements, i.e. half the number of reals including the padding.
+    [[nodiscard]] size_t size() const { return storage.size(); }
+
+  private:
+    typename layout_r2c_padded::template mapping<Extents> real_mapping;
+    basic_buffer<Real, Complex, false, Storage> storage;
+};
+
+} // namespace fftw
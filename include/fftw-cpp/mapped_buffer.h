@@ -0,0 +1,192 @@
+#pragma once
+
+#include "basic_buffer.h"
+#include "include_mdspan.h"
+#include "util.h"
+#include <cerrno>
+#include <complex>
+#include <cstddef>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fftw {
+
+/// Storage policy backed by anonymous huge-page mappings, for large grids where TLB misses add up.
+/// Allocations of at least one huge page are rounded up to whole huge pages and mapped with
+/// MAP_HUGETLB; if no huge pages are reserved, a regular mapping is used with
+/// madvise(MADV_HUGEPAGE), so transparent huge pages can back it. Smaller allocations use
+/// fftw_malloc. Mappings are page-aligned, which satisfies FFTW's SIMD alignment.
+template <std::floating_point Real> struct hugepage_allocator {
+    static constexpr size_t huge_page_size = size_t{2} << 20;
+
+    static void *allocate(size_t bytes) {
+        if (bytes < huge_page_size) { return fftw_allocator<Real>::allocate(bytes); }
+
+        auto length = rounded(bytes);
+        int huge_flags = MAP_HUGETLB;
+#ifdef MAP_HUGE_2MB
+        huge_flags |= MAP_HUGE_2MB;
+#endif
+        void *ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | huge_flags, -1, 0);
+        if (ptr != MAP_FAILED) { return ptr; }
+
+        ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) { return nullptr; }
+#ifdef MADV_HUGEPAGE
+        madvise(ptr, length, MADV_HUGEPAGE); // only a hint, failure is harmless
+#endif
+        return ptr;
+    }
+
+    static void deallocate(void *ptr, size_t bytes) noexcept {
+        if (bytes < huge_page_size) {
+            fftw_allocator<Real>::deallocate(ptr, bytes);
+        } else {
+            munmap(ptr, rounded(bytes));
+        }
+    }
+
+  private:
+    static size_t rounded(size_t bytes) {
+        return (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+    }
+};
+
+/// How basic_mapped_file maps its file.
+enum class map_mode {
+    /// The file is never modified: pages are copied on write, so plans may still use the
+    /// mapping as scratch space (FFTW writes to the input while planning with MEASURE, and
+    /// out-of-place c2r transforms destroy their input).
+    READ,
+    /// Writes go to the file, e.g. for transform output.
+    READ_WRITE,
+    /// Like READ_WRITE, but the file is created (or truncated) with the requested size.
+    CREATE,
+};
+
+/// A file mapped into memory as an array of real or complex elements, so that transforms can read
+/// their input straight from disk and write their output back to it, with the OS paging data in
+/// and out instead of the whole array being read into RAM.
+/// Storage policies are stateless, so a mapping is not a basic_buffer; plans use it through
+/// view() (1D) or to_mdspan() (any rank). Mappings are page-aligned, so the views are
+/// SIMD-aligned.
+///
+/// \code
+/// fftw::rmapped_file input{"field.f64", fftw::map_mode::READ};
+/// fftw::mapped_file output{"spectrum.c128", fftw::map_mode::CREATE, ny * (nx / 2 + 1)};
+/// auto p = fftw::plan_r2c<2>::dft(input.to_mdspan(ny, nx), output.to_mdspan(ny, nx / 2 + 1),
+///                                 fftw::ESTIMATE);
+/// p();
+/// \endcode
+template <class Real, class Complex = std::complex<Real>, bool IsReal = false>
+class basic_mapped_file {
+  public:
+    using element_type = std::conditional_t<IsReal, Real, Complex>;
+
+    /// Maps the whole file; its size must be a multiple of the element size.
+    /// With CREATE, the file is created or truncated to hold `elements` elements.
+    basic_mapped_file(const std::filesystem::path &path, map_mode mode, size_t elements = 0) {
+        int flags = mode == map_mode::READ ? O_RDONLY : O_RDWR;
+        if (mode == map_mode::CREATE) { flags |= O_CREAT | O_TRUNC; }
+
+        int fd = ::open(path.c_str(), flags, 0644);
+        if (fd < 0) { throw_errno("failed to open " + path.string()); }
+
+        struct stat st {};
+        if (mode == map_mode::CREATE) {
+            if (::ftruncate(fd, off_t(elements * sizeof(element_type))) != 0) {
+                close_and_throw(fd, "failed to resize " + path.string());
+            }
+            bytes = elements * sizeof(element_type);
+        } else {
+            if (::fstat(fd, &st) != 0) { close_and_throw(fd, "failed to stat " + path.string()); }
+            bytes = size_t(st.st_size);
+            if (bytes % sizeof(element_type) != 0) {
+                ::close(fd);
+                throw std::invalid_argument(path.string() + " is not a whole number of elements");
+            }
+        }
+
+        if (bytes != 0) {
+            int share = mode == map_mode::READ ? MAP_PRIVATE : MAP_SHARED;
+            void *ptr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, share, fd, 0);
+            if (ptr == MAP_FAILED) { close_and_throw(fd, "failed to map " + path.string()); }
+            mapping = static_cast<element_type *>(ptr);
+        }
+        ::close(fd); // the mapping keeps the file referenced
+    }
+
+    basic_mapped_file(basic_mapped_file &&other) noexcept
+        : mapping(std::exchange(other.mapping, nullptr)), bytes(std::exchange(other.bytes, 0)) {}
+
+    basic_mapped_file &operator=(basic_mapped_file &&other) noexcept {
+        if (this != &other) {
+            unmap();
+            mapping = std::exchange(other.mapping, nullptr);
+            bytes = std::exchange(other.bytes, 0);
+        }
+        return *this;
+    }
+
+    basic_mapped_file(const basic_mapped_file &) = delete;
+    basic_mapped_file &operator=(const basic_mapped_file &) = delete;
+
+    ~basic_mapped_file() { unmap(); }
+
+    element_type *data() const { return mapping; }
+    [[nodiscard]] size_t size() const { return bytes / sizeof(element_type); }
+
+    /// The mapping as a 1D buffer view.
+    basic_buffer_view<Real, Complex, IsReal> view() const { return {mapping, size()}; }
+
+    /// The mapping as a row-major view of the given extents, which must fit in the file.
+    template <class... Extents> auto to_mdspan(Extents... extents) const {
+        using view_t = MDSPAN::mdspan<element_type, MDSPAN::dextents<size_t, sizeof...(Extents)>>;
+        if ((size_t(extents) * ... * size_t{1}) > size()) {
+            throw std::invalid_argument("extents larger than the mapped file");
+        }
+        return view_t{mapping, size_t(extents)...};
+    }
+
+    /// Writes modified pages back to the file now instead of whenever the OS decides to.
+    void sync() const {
+        if (mapping != nullptr && ::msync(mapping, bytes, MS_SYNC) != 0) {
+            throw_errno("failed to sync mapped file");
+        }
+    }
+
+  private:
+    [[noreturn]] static void throw_errno(const std::string &what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    [[noreturn]] static void close_and_throw(int fd, const std::string &what) {
+        auto error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), what);
+    }
+
+    void unmap() noexcept {
+        if (mapping != nullptr) { ::munmap(mapping, bytes); }
+        mapping = nullptr;
+        bytes = 0;
+    }
+
+    element_type *mapping{nullptr};
+    size_t bytes{0};
+};
+
+template <class Real, class Complex = std::complex<Real>>
+using basic_rmapped_file = basic_mapped_file<Real, Complex, true>;
+
+} // namespace fftw
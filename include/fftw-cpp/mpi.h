@@ -0,0 +1,359 @@
+#pragma once
+
+#include "basic_plan.h"
+#include "include_mdspan.h"
+#include "layout_r2c_padded.h"
+#include "util.h"
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+
+#include <fftw3-mpi.h>
+#include <mpi.h>
+
+namespace fftw {
+
+/// The first two dimensions of the input (TRANSPOSED_IN) or output (TRANSPOSED_OUT) of a
+/// distributed plan are transposed, i.e. the array is distributed along the second dimension.
+/// This saves one global transpose; a forward plan with TRANSPOSED_OUT and a backward plan with
+/// TRANSPOSED_IN are the usual pair, e.g. for spectral solvers that work in the transposed layout.
+inline constexpr Flags TRANSPOSED_IN = Flags(FFTW_MPI_TRANSPOSED_IN);
+inline constexpr Flags TRANSPOSED_OUT = Flags(FFTW_MPI_TRANSPOSED_OUT);
+
+namespace detail {
+/// Maps a real type to the functions of the matching fftw3-mpi library, like fftw_types.
+template <std::floating_point Real> struct fftw_mpi_types;
+
+#define FFTW_CPP_DEFINE_MPI_TYPES(R, X)                                                            \
+    template <> struct fftw_mpi_types<R> {                                                         \
+        static constexpr auto init = &X##mpi_init;                                                 \
+        static constexpr auto cleanup = &X##mpi_cleanup;                                           \
+        static constexpr auto local_size_transposed = &X##mpi_local_size_transposed;               \
+                                                                                                   \
+        static constexpr auto plan_dft = &X##mpi_plan_dft;                                         \
+        static constexpr auto plan_dft_r2c = &X##mpi_plan_dft_r2c;                                 \
+        static constexpr auto plan_dft_c2r = &X##mpi_plan_dft_c2r;                                 \
+                                                                                                   \
+        static constexpr auto execute_dft = &X##mpi_execute_dft;                                   \
+        static constexpr auto execute_dft_r2c = &X##mpi_execute_dft_r2c;                           \
+        static constexpr auto execute_dft_c2r = &X##mpi_execute_dft_c2r;                           \
+    }
+
+FFTW_CPP_DEFINE_MPI_TYPES(double, fftw_);
+#ifdef FFTW_CPP_FLOAT
+FFTW_CPP_DEFINE_MPI_TYPES(float, fftwf_);
+#endif
+#ifdef FFTW_CPP_LONG_DOUBLE
+FFTW_CPP_DEFINE_MPI_TYPES(long double, fftwl_);
+#endif
+
+#undef FFTW_CPP_DEFINE_MPI_TYPES
+
+/// Whether fftw3-mpi of a precision is initialized. Must hold planner_mutex().
+template <std::floating_point Real> bool &mpi_initialized() {
+    static bool initialized = false;
+    return initialized;
+}
+
+/// Initializes fftw3-mpi of a precision, unless it already is. MPI itself must be initialized.
+/// FFTW requires the threads library to be initialized first, so this initializes it too.
+/// Must hold planner_mutex().
+template <std::floating_point Real> void init_mpi() {
+#ifdef FFTW_CPP_THREADS
+    init_threads<Real>();
+#endif
+    if (mpi_initialized<Real>()) { return; }
+    fftw_mpi_types<Real>::init();
+    mpi_initialized<Real>() = true;
+}
+} // namespace detail
+
+/// Scopes fftw3-mpi to the lifetime of this object, between MPI_Init and MPI_Finalize.
+/// fftw3-mpi is initialized lazily by the first distributed plan anyway, so this is only needed to
+/// release its resources at a defined point. All distributed plans must be destroyed first;
+/// distributed plans created afterwards initialize fftw3-mpi again.
+template <std::floating_point Real = double> class basic_mpi_guard {
+  public:
+    basic_mpi_guard() {
+        std::lock_guard lock{detail::planner_mutex()};
+        detail::init_mpi<Real>();
+    }
+
+    basic_mpi_guard(const basic_mpi_guard &) = delete;
+    basic_mpi_guard &operator=(const basic_mpi_guard &) = delete;
+
+    ~basic_mpi_guard() {
+        std::lock_guard lock{detail::planner_mutex()};
+        if (!detail::mpi_initialized<Real>()) { return; }
+        detail::fftw_mpi_types<Real>::cleanup();
+        detail::mpi_initialized<Real>() = false;
+    }
+};
+
+/// How the arrays of a distributed transform are split over the processes of a communicator.
+/// Every process holds a slab of consecutive indices of the first dimension, or of the second one
+/// for the transposed layout (see TRANSPOSED_IN and TRANSPOSED_OUT). complex_view() and
+/// real_view() view this process' slab of a buffer of alloc_local complex elements.
+template <size_t D> struct mpi_distribution {
+    std::array<std::ptrdiff_t, D> n{}; ///< logical (real, for r2c/c2r) global extents
+    bool real{false}; ///< r2c/c2r: the last complex extent is n / 2 + 1, real rows are padded
+    std::ptrdiff_t local_n0{0}, local_0_start{0}; ///< this process' slab of the first dimension
+    std::ptrdiff_t local_n1{0}, local_1_start{0}; ///< this process' slab of the second dimension
+    size_t alloc_local{0}; ///< complex elements to allocate for each array (at least 1)
+
+    /// Global extents of the complex arrays.
+    [[nodiscard]] std::array<std::ptrdiff_t, D> complex_n() const {
+        auto c = n;
+        if (real) { c[D - 1] = c[D - 1] / 2 + 1; }
+        return c;
+    }
+
+    /// Extents of this process' complex slab: (local_n0, n1, ...) or, transposed,
+    /// (local_n1, n0, n2, ...).
+    [[nodiscard]] MDSPAN::dextents<size_t, D> complex_extents(bool transposed = false) const {
+        std::array<size_t, D> e{};
+        auto c = complex_n();
+        for (size_t k = 0; k < D; ++k) {
+            e[k] = size_t(c[k]);
+        }
+        if (transposed) {
+            e[0] = size_t(local_n1);
+            e[1] = size_t(c[0]);
+        } else {
+            e[0] = size_t(local_n0);
+        }
+        return MDSPAN::dextents<size_t, D>{e};
+    }
+
+    /// Extents of this process' real slab (local_n0, n1, ..., n_{D-1}), without padding.
+    [[nodiscard]] MDSPAN::dextents<size_t, D> real_extents() const {
+        std::array<size_t, D> e{};
+        for (size_t k = 0; k < D; ++k) {
+            e[k] = size_t(n[k]);
+        }
+        e[0] = size_t(local_n0);
+        return MDSPAN::dextents<size_t, D>{e};
+    }
+
+    template <class Complex>
+    [[nodiscard]] auto complex_view(Complex *data, bool transposed = false) const {
+        return MDSPAN::mdspan<Complex, MDSPAN::dextents<size_t, D>>{data,
+                                                                     complex_extents(transposed)};
+    }
+
+    /// The padded real view fftw3-mpi uses for r2c input and c2r output, in- and out-of-place.
+    template <class Real> [[nodiscard]] auto real_view(Real *data) const {
+        if (!real) { throw std::logic_error("real_view of a complex distribution"); }
+        return MDSPAN::mdspan<Real, MDSPAN::dextents<size_t, D>, layout_r2c_padded>{
+            data, real_extents()};
+    }
+};
+
+namespace detail {
+
+template <size_t D, std::floating_point Real>
+mpi_distribution<D> mpi_local_size(std::array<std::ptrdiff_t, D> n, bool real, MPI_Comm comm) {
+    static_assert(D >= 2u, "distributed transforms need at least two dimensions");
+    for (auto extent : n) {
+        if (extent <= 0) { throw std::invalid_argument("non-positive extent"); }
+    }
+
+    mpi_distribution<D> dist{n, real};
+    auto c = dist.complex_n();
+    std::lock_guard lock{planner_mutex()};
+    init_mpi<Real>();
+    auto alloc = fftw_mpi_types<Real>::local_size_transposed(int(D), c.data(), comm, &dist.local_n0,
+                                                             &dist.local_0_start, &dist.local_n1,
+                                                             &dist.local_1_start);
+    dist.alloc_local = std::max<size_t>(size_t(alloc), 1u);
+    return dist;
+}
+
+template <size_t D, typename View>
+void validate_mpi_view(const View &view, const MDSPAN::dextents<size_t, D> &expected) {
+    for (size_t k = 0; k < D; ++k) {
+        if (size_t(view.extent(k)) != expected.extent(k)) {
+            throw std::invalid_argument("Extents don't match the MPI distribution");
+        }
+    }
+}
+
+inline bool has_flag(Flags flags, Flags flag) { return (unsigned(flags) & unsigned(flag)) != 0; }
+
+} // namespace detail
+
+/// Distributed complex-to-complex transform of rank D >= 2 over an MPI communicator.
+/// Every process plans and executes collectively on its local slab, see mpi_distribution.
+///
+/// \code
+/// auto dist = fftw::mpi_plan<3>::local_size({n0, n1, n2}, MPI_COMM_WORLD);
+/// fftw::buffer data(dist.alloc_local);
+/// auto p = fftw::mpi_plan<3>::dft(dist.complex_view(data.data()), dist.complex_view(data.data()),
+///                                 dist, MPI_COMM_WORLD, fftw::FORWARD, fftw::MEASURE);
+/// p();
+/// \endcode
+template <size_t D, class Real, class Complex = std::complex<Real>>
+class basic_mpi_plan : public plan_base<D, Real, Complex> {
+  private:
+    using base = plan_base<D, Real, Complex>;
+
+  public:
+    using real_t = Real;
+    using complex_t = Complex;
+    using view_t = MDSPAN::mdspan<Complex, MDSPAN::dextents<size_t, D>>;
+
+    using base::c_plan;
+    using base::plan_base;
+
+    /// Splits a transform of global extents n over the communicator.
+    static mpi_distribution<D> local_size(std::array<std::ptrdiff_t, D> n, MPI_Comm comm) {
+        return detail::mpi_local_size<D, Real>(n, false, comm);
+    }
+
+    /// Executes the plan (collectively) with the arrays provided initially.
+    void operator()() const {
+        auto timer = this->time_execution();
+        detail::fftw_types<Real>::execute(c_plan());
+    }
+
+    /// Executes the plan on other arrays of the same distribution and alignment.
+    void operator()(view_t in, view_t out) const {
+        auto timer = this->time_execution();
+        detail::fftw_mpi_types<Real>::execute_dft(c_plan(),
+                                                  detail::unwrap<false, Real, Complex>(in),
+                                                  detail::unwrap<false, Real, Complex>(out));
+    }
+
+    /// Plans collectively; in and out may be the same memory.
+    static auto dft(view_t in, view_t out, const mpi_distribution<D> &dist, MPI_Comm comm,
+                    Direction direction, Flags flags, int threads = 1) -> basic_mpi_plan {
+        if (direction != FORWARD and direction != BACKWARD) {
+            throw std::invalid_argument("invalid direction");
+        }
+        if (dist.real) { throw std::invalid_argument("real distribution for a complex plan"); }
+        detail::validate_mpi_view<D>(in,
+                                     dist.complex_extents(detail::has_flag(flags, TRANSPOSED_IN)));
+        detail::validate_mpi_view<D>(out,
+                                     dist.complex_extents(detail::has_flag(flags, TRANSPOSED_OUT)));
+
+        std::lock_guard lock{detail::planner_mutex()};
+        detail::init_mpi<Real>();
+        detail::plan_with_threads<Real>(threads);
+        auto c_plan = detail::fftw_mpi_types<Real>::plan_dft(
+            int(D), dist.n.data(), detail::unwrap<false, Real, Complex>(in),
+            detail::unwrap<false, Real, Complex>(out), comm, direction, unsigned(flags));
+        if (c_plan == nullptr) { throw std::runtime_error("failed to create MPI plan"); }
+        return basic_mpi_plan{c_plan};
+    }
+};
+
+/// Distributed real-to-complex transform, see basic_mpi_plan.
+/// The real input is always in the padded layout (layout_r2c_padded), also out-of-place.
+/// TRANSPOSED_OUT applies to the complex output.
+template <size_t D, class Real, class Complex = std::complex<Real>>
+class basic_mpi_plan_r2c : public plan_base<D, Real, Complex> {
+  private:
+    using base = plan_base<D, Real, Complex>;
+
+  public:
+    using real_t = Real;
+    using complex_t = Complex;
+    using real_view_t = MDSPAN::mdspan<Real, MDSPAN::dextents<size_t, D>, layout_r2c_padded>;
+    using complex_view_t = MDSPAN::mdspan<Complex, MDSPAN::dextents<size_t, D>>;
+
+    using base::c_plan;
+    using base::plan_base;
+
+    /// Splits a transform of logical (real) global extents n over the communicator.
+    static mpi_distribution<D> local_size(std::array<std::ptrdiff_t, D> n, MPI_Comm comm) {
+        return detail::mpi_local_size<D, Real>(n, true, comm);
+    }
+
+    void operator()() const {
+        auto timer = this->time_execution();
+        detail::fftw_types<Real>::execute(c_plan());
+    }
+
+    void operator()(real_view_t in, complex_view_t out) const {
+        auto timer = this->time_execution();
+        detail::fftw_mpi_types<Real>::execute_dft_r2c(c_plan(),
+                                                      detail::unwrap<true, Real, Complex>(in),
+                                                      detail::unwrap<false, Real, Complex>(out));
+    }
+
+    static auto dft(real_view_t in, complex_view_t out, const mpi_distribution<D> &dist,
+                    MPI_Comm comm, Flags flags, int threads = 1) -> basic_mpi_plan_r2c {
+        if (!dist.real) { throw std::invalid_argument("complex distribution for a real plan"); }
+        if (detail::has_flag(flags, TRANSPOSED_IN)) {
+            throw std::invalid_argument("TRANSPOSED_IN does not apply to r2c plans");
+        }
+        detail::validate_mpi_view<D>(in, dist.real_extents());
+        detail::validate_mpi_view<D>(out,
+                                     dist.complex_extents(detail::has_flag(flags, TRANSPOSED_OUT)));
+
+        std::lock_guard lock{detail::planner_mutex()};
+        detail::init_mpi<Real>();
+        detail::plan_with_threads<Real>(threads);
+        auto c_plan = detail::fftw_mpi_types<Real>::plan_dft_r2c(
+            int(D), dist.n.data(), detail::unwrap<true, Real, Complex>(in),
+            detail::unwrap<false, Real, Complex>(out), comm, unsigned(flags));
+        if (c_plan == nullptr) { throw std::runtime_error("failed to create MPI plan"); }
+        return basic_mpi_plan_r2c{c_plan};
+    }
+};
+
+/// Distributed complex-to-real transform, see basic_mpi_plan_r2c.
+/// TRANSPOSED_IN applies to the complex input. Like serial c2r plans, the input is overwritten.
+template <size_t D, class Real, class Complex = std::complex<Real>>
+class basic_mpi_plan_c2r : public plan_base<D, Real, Complex> {
+  private:
+    using base = plan_base<D, Real, Complex>;
+
+  public:
+    using real_t = Real;
+    using complex_t = Complex;
+    using real_view_t = MDSPAN::mdspan<Real, MDSPAN::dextents<size_t, D>, layout_r2c_padded>;
+    using complex_view_t = MDSPAN::mdspan<Complex, MDSPAN::dextents<size_t, D>>;
+
+    using base::c_plan;
+    using base::plan_base;
+
+    static mpi_distribution<D> local_size(std::array<std::ptrdiff_t, D> n, MPI_Comm comm) {
+        return detail::mpi_local_size<D, Real>(n, true, comm);
+    }
+
+    void operator()() const {
+        auto timer = this->time_execution();
+        detail::fftw_types<Real>::execute(c_plan());
+    }
+
+    void operator()(complex_view_t in, real_view_t out) const {
+        auto timer = this->time_execution();
+        detail::fftw_mpi_types<Real>::execute_dft_c2r(c_plan(),
+                                                      detail::unwrap<false, Real, Complex>(in),
+                                                      detail::unwrap<true, Real, Complex>(out));
+    }
+
+    static auto dft(complex_view_t in, real_view_t out, const mpi_distribution<D> &dist,
+                    MPI_Comm comm, Flags flags, int threads = 1) -> basic_mpi_plan_c2r {
+        if (!dist.real) { throw std::invalid_argument("complex distribution for a real plan"); }
+        if (detail::has_flag(flags, TRANSPOSED_OUT)) {
+            throw std::invalid_argument("TRANSPOSED_OUT does not apply to c2r plans");
+        }
+        detail::validate_mpi_view<D>(in,
+                                     dist.complex_extents(detail::has_flag(flags, TRANSPOSED_IN)));
+        detail::validate_mpi_view<D>(out, dist.real_extents());
+
+        std::lock_guard lock{detail::planner_mutex()};
+        detail::init_mpi<Real>();
+        detail::plan_with_threads<Real>(threads);
+        auto c_plan = detail::fftw_mpi_types<Real>::plan_dft_c2r(
+            int(D), dist.n.data(), detail::unwrap<false, Real, Complex>(in),
+            detail::unwrap<true, Real, Complex>(out), comm, unsigned(flags));
+        if (c_plan == nullptr) { throw std::runtime_error("failed to create MPI plan"); }
+        return basic_mpi_plan_c2r{c_plan};
+    }
+};
+
+} // namespace fftw
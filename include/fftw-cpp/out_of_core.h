@@ -0,0 +1,245 @@
+#pragma once
+
+#include "basic_batched_plan.h"
+#include "basic_buffer.h"
+#include "util.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <complex>
+#include <cstddef>
+#include <filesystem>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace fftw {
+
+/// I/O and timing of one out-of-core transform.
+struct out_of_core_stats {
+    size_t bytes_read{0};
+    size_t bytes_written{0};
+    double seconds{0.0};
+
+    /// Achieved I/O throughput, in GB/s (10^9 bytes).
+    [[nodiscard]] double gb_per_second() const {
+        return seconds > 0.0 ? double(bytes_read + bytes_written) / seconds / 1e9 : 0.0;
+    }
+};
+
+namespace detail {
+
+/// A file descriptor with whole-range positional I/O.
+class io_file {
+  public:
+    io_file(const std::filesystem::path &path, int flags) : fd(::open(path.c_str(), flags, 0644)) {
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "failed to open " + path.string());
+        }
+    }
+    io_file(const io_file &) = delete;
+    io_file &operator=(const io_file &) = delete;
+    ~io_file() { ::close(fd); }
+
+    void read(void *data, size_t bytes, size_t offset) const {
+        auto *ptr = static_cast<char *>(data);
+        while (bytes > 0) {
+            auto n = ::pread(fd, ptr, bytes, off_t(offset));
+            if (n < 0 && errno == EINTR) { continue; }
+            if (n <= 0) { throw std::system_error(errno, std::generic_category(), "read failed"); }
+            ptr += n, offset += size_t(n), bytes -= size_t(n);
+        }
+    }
+
+    void write(const void *data, size_t bytes, size_t offset) const {
+        const auto *ptr = static_cast<const char *>(data);
+        while (bytes > 0) {
+            auto n = ::pwrite(fd, ptr, bytes, off_t(offset));
+            if (n < 0 && errno == EINTR) { continue; }
+            if (n < 0) { throw std::system_error(errno, std::generic_category(), "write failed"); }
+            ptr += n, offset += size_t(n), bytes -= size_t(n);
+        }
+    }
+
+    void resize(size_t bytes) const {
+        if (::ftruncate(fd, off_t(bytes)) != 0) {
+            throw std::system_error(errno, std::generic_category(), "failed to resize file");
+        }
+    }
+
+  private:
+    int fd;
+};
+
+/// A scratch file in the temporary directory that no other transform uses at the same time:
+/// the name includes the process id and a per-process counter.
+inline std::filesystem::path unique_scratch_path() {
+    static std::atomic<unsigned long long> counter{0};
+    return std::filesystem::temp_directory_path() /
+           ("fftw-cpp-ooc-" + std::to_string(::getpid()) + "-" + std::to_string(counter++) +
+            ".scratch");
+}
+
+} // namespace detail
+
+/// 2D complex transform of a row-major array stored in a file, for arrays larger than RAM.
+/// The transform takes two passes over the data. Each pass reads slabs of consecutive rows,
+/// transforms every row of a slab with one batched plan, transposes the slab in memory and writes
+/// it into the columns of the destination. The first pass goes from the input to a scratch file
+/// (holding the transposed array), the second from the scratch file to the output, which ends up
+/// in the original row-major layout. Reading the next slab and writing the previous one overlap
+/// with the transform of the current one (double buffering).
+///
+/// The result matches basic_plan<2> on the same array in memory. Input and output may be the same
+/// file.
+template <class Real, class Complex = std::complex<Real>> class basic_out_of_core_fft {
+  public:
+    struct options {
+        /// Memory for slab buffers (two read and two write buffers); ignored if slab_rows is set.
+        size_t memory_budget{size_t{256} << 20};
+        size_t slab_rows{0}; ///< rows per slab in both passes, 0 derives it from memory_budget
+        Flags flags{ESTIMATE};
+        int threads{1};
+        /// Empty uses a new file in the temporary directory for every transform() call; an explicit
+        /// path must not be shared by concurrent transforms.
+        std::filesystem::path scratch{};
+    };
+
+    basic_out_of_core_fft(size_t rows, size_t cols, Direction direction)
+        : basic_out_of_core_fft(rows, cols, direction, options{}) {}
+
+    basic_out_of_core_fft(size_t rows, size_t cols, Direction direction, options opts)
+        : rows(rows), cols(cols), opts(std::move(opts)), row_pass(make_pass(cols, rows, direction)),
+          column_pass(make_pass(rows, cols, direction)) {}
+
+    /// Transforms the rows x cols complex array in `input` into `output`.
+    /// Not thread-safe: all calls use the engine's slab buffers and plans, so concurrent transforms
+    /// need an engine each.
+    out_of_core_stats transform(const std::filesystem::path &input,
+                                const std::filesystem::path &output) {
+        auto scratch = opts.scratch.empty() ? detail::unique_scratch_path() : opts.scratch;
+        auto bytes = rows * cols * sizeof(Complex);
+        if (std::filesystem::file_size(input) < bytes) {
+            throw std::invalid_argument("input file smaller than the array");
+        }
+
+        out_of_core_stats stats;
+        auto start = std::chrono::steady_clock::now();
+        {
+            detail::io_file in{input, O_RDONLY};
+            detail::io_file tmp{scratch, O_RDWR | O_CREAT | O_TRUNC};
+            tmp.resize(bytes);
+            run_pass(row_pass, in, tmp, stats);
+        }
+        {
+            detail::io_file tmp{scratch, O_RDONLY};
+            detail::io_file out{output, O_RDWR | O_CREAT};
+            out.resize(std::max<size_t>(bytes, std::filesystem::file_size(output)));
+            run_pass(column_pass, tmp, out, stats);
+        }
+        stats.seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::error_code ec;
+        std::filesystem::remove(scratch, ec);
+        return stats;
+    }
+
+    /// Rows per slab in the first and second pass.
+    [[nodiscard]] std::pair<size_t, size_t> slab_rows() const {
+        return {row_pass.slab, column_pass.slab};
+    }
+
+  private:
+    using plan_t = basic_batched_plan<1u, Real, Complex>;
+    using buffer_t = basic_buffer<Real, Complex>;
+
+    /// One pass: transform rows of length n of an array with `count` rows, write transposed.
+    struct pass {
+        size_t n;
+        size_t count;
+        size_t slab;
+        std::array<buffer_t, 2> slabs;
+        std::array<buffer_t, 2> transposed;
+        plan_t plan;
+    };
+
+    pass make_pass(size_t n, size_t count, Direction direction) {
+        if (n == 0 || count == 0) { throw std::invalid_argument("empty out-of-core array"); }
+        auto slab = opts.slab_rows;
+        if (slab == 0) {
+            slab = std::max<size_t>(1, opts.memory_budget / (4 * n * sizeof(Complex)));
+        }
+        slab = std::min(slab, count);
+
+        pass p{n, count, slab, {buffer_t(slab * n), buffer_t(slab * n)},
+               {buffer_t(slab * n), buffer_t(slab * n)}, {}};
+        batch_stride layout{1, int(n)};
+        p.plan = plan_t::dft({int(n)}, int(slab), p.slabs[0], layout, p.slabs[0], layout, direction,
+                             opts.flags, opts.threads);
+        return p;
+    }
+
+    /// Reads slabs of rows from `in`, transforms them, and writes them as columns of `out`,
+    /// which has p.n rows of p.count elements.
+    void run_pass(pass &p, const detail::io_file &in, const detail::io_file &out,
+                  out_of_core_stats &stats) {
+        auto row_bytes = p.n * sizeof(Complex);
+        auto slabs = (p.count + p.slab - 1) / p.slab;
+        auto rows_in = [&](size_t s) { return std::min(p.slab, p.count - s * p.slab); };
+
+        auto read = [&](size_t s) {
+            in.read(p.slabs[s % 2].data(), rows_in(s) * row_bytes, s * p.slab * row_bytes);
+        };
+        auto write = [&](size_t s) {
+            // row j of the transposed slab is a contiguous piece of row j of the destination
+            auto r = rows_in(s);
+            for (size_t j = 0; j < p.n; ++j) {
+                out.write(p.transposed[s % 2].data() + j * r, r * sizeof(Complex),
+                          (j * p.count + s * p.slab) * sizeof(Complex));
+            }
+        };
+
+        std::future<void> reading = std::async(std::launch::async, read, 0);
+        std::array<std::future<void>, 2> writing;
+        for (size_t s = 0; s < slabs; ++s) {
+            reading.get();
+            if (s + 1 < slabs) { reading = std::async(std::launch::async, read, s + 1); }
+
+            auto &slab = p.slabs[s % 2];
+            p.plan(slab, slab);
+
+            if (writing[s % 2].valid()) { writing[s % 2].get(); }
+            auto r = rows_in(s);
+            auto &t = p.transposed[s % 2];
+            for (size_t i = 0; i < r; ++i) {
+                for (size_t j = 0; j < p.n; ++j) {
+                    t[j * r + i] = slab[i * p.n + j];
+                }
+            }
+            writing[s % 2] = std::async(std::launch::async, write, s);
+
+            stats.bytes_read += r * row_bytes;
+            stats.bytes_written += r * row_bytes;
+        }
+        for (auto &w : writing) {
+            if (w.valid()) { w.get(); }
+        }
+    }
+
+    size_t rows;
+    size_t cols;
+    options opts;
+    pass row_pass;
+    pass column_pass;
+};
+
+} // namespace fftw
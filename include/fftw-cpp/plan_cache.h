@@ -0,0 +1,231 @@
+#pragma once
+
+#include "basic_plan.h"
+#include "util.h"
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace fftw {
+
+namespace detail {
+
+/// Identifies a plan by its type (rank, precision, transform kind) and everything that FFTW needs
+/// to be identical for new-array execution: extents, strides (and hence layout), in-place-ness,
+/// alignment class of every array, and the remaining scalar arguments (direction, flags).
+struct plan_key {
+    std::type_index plan_type;
+    std::vector<std::int64_t> words;
+
+    bool operator==(const plan_key &) const = default;
+};
+
+struct plan_key_hash {
+    size_t operator()(const plan_key &key) const noexcept {
+        size_t seed = key.plan_type.hash_code();
+        for (auto word : key.words) {
+            seed ^= std::hash<std::int64_t>{}(word) + 0x9e3779b97f4a7c15ull + (seed << 6) +
+                    (seed >> 2);
+        }
+        return seed;
+    }
+};
+
+/// FFTW only requires the SIMD alignment (not the address) to match for new-array execution.
+inline std::int64_t alignment_class(const void *ptr) {
+    return fftw_alignment_of(reinterpret_cast<double *>(const_cast<void *>(ptr)));
+}
+
+struct plan_key_builder {
+    std::vector<std::int64_t> words;
+    std::vector<const void *> arrays;
+
+    void add_array(const void *ptr, size_t rank) {
+        arrays.push_back(ptr);
+        words.push_back(std::int64_t(rank));
+        words.push_back(alignment_class(ptr));
+    }
+
+    template <typename T> void add(const T &arg) {
+        if constexpr (mdspan_like<T>) {
+            add_array(arg.data_handle(), T::rank());
+            for (size_t r = 0; r < T::rank(); ++r) {
+                words.push_back(std::int64_t(arg.extent(r)));
+                words.push_back(std::int64_t(arg.mapping().stride(r)));
+            }
+        } else if constexpr (mdarray_like<T>) {
+            add(arg.to_mdspan());
+        } else if constexpr (buffer_like<T>) {
+            add_array(arg.data(), 1u);
+            words.push_back(std::int64_t(arg.size()));
+            words.push_back(1);
+        } else if constexpr (std::is_enum_v<T> || std::is_arithmetic_v<T>) {
+            words.push_back(std::int64_t(arg));
+        } else if constexpr (std::ranges::range<T>) {
+            // e.g. the per-dimension kinds of an r2r plan
+            words.push_back(std::int64_t(std::ranges::size(arg)));
+            for (const auto &element : arg) {
+                add(element);
+            }
+        } else {
+            static_assert(always_false<T>, "Unsupported planning argument");
+        }
+    }
+
+    /// Records which arrays alias each other, so in-place and out-of-place plans never collide.
+    void add_aliasing() {
+        for (size_t i = 0; i < arrays.size(); ++i) {
+            for (size_t j = i + 1; j < arrays.size(); ++j) {
+                words.push_back(arrays[i] == arrays[j]);
+            }
+        }
+    }
+};
+
+template <class Plan, typename... Args> plan_key make_plan_key(const Args &...args) {
+    plan_key_builder builder;
+    (builder.add(args), ...);
+    builder.add_aliasing();
+    return {std::type_index(typeid(Plan)), std::move(builder.words)};
+}
+
+} // namespace detail
+
+/// Counters reported by plan_cache::stats().
+struct plan_cache_stats {
+    size_t hits{0};
+    size_t misses{0};
+    size_t evictions{0};
+    size_t size{0};
+    size_t capacity{0};
+};
+
+/// A thread-safe, bounded LRU cache of plans.
+/// Plans are keyed on the transform descriptor (plan type, extents, strides, in-place-ness,
+/// alignment class, direction and flags) and shared between callers, which execute them on
+/// their own arrays through the new-array `operator()(in, out)` overloads.
+///
+/// On a miss the plan is created on the arrays passed in, exactly like `Plan::dft`, so planning
+/// with MEASURE or PATIENT overwrites their contents.
+class plan_cache {
+  public:
+    static constexpr size_t default_capacity = 128u;
+
+    explicit plan_cache(size_t capacity = default_capacity) : max_size(capacity) {}
+
+    plan_cache(const plan_cache &) = delete;
+    plan_cache &operator=(const plan_cache &) = delete;
+
+    /// The process-wide cache.
+    static plan_cache &global() {
+        static plan_cache cache;
+        return cache;
+    }
+
+    /// Returns a shared plan equivalent to `Plan::dft(args...)`, planning it only on a miss.
+    template <class Plan, typename... Args> auto get(Args &&...args) -> std::shared_ptr<const Plan>;
+
+    [[nodiscard]] plan_cache_stats stats() const;
+
+    [[nodiscard]] size_t capacity() const;
+
+    /// Changes the maximum number of cached plans, evicting the least recently used ones.
+    void set_capacity(size_t capacity);
+
+    /// Drops all plans (plans still held by callers stay valid) and resets the counters.
+    void clear();
+
+  private:
+    using entry = std::pair<detail::plan_key, std::shared_ptr<const void>>;
+    using entry_list = std::list<entry>;
+
+    /// Trims the cache down to capacity, moving evicted plans into `evicted` so that they are
+    /// destroyed after the lock is released.
+    void trim(std::vector<std::shared_ptr<const void>> &evicted);
+
+    mutable std::mutex mutex;
+    size_t max_size;
+    entry_list entries; ///< most recently used first
+    std::unordered_map<detail::plan_key, entry_list::iterator, detail::plan_key_hash> index;
+    plan_cache_stats counters;
+};
+
+template <class Plan, typename... Args>
+auto plan_cache::get(Args &&...args) -> std::shared_ptr<const Plan> {
+    auto key = detail::make_plan_key<Plan>(std::as_const(args)...);
+
+    {
+        std::lock_guard lock{mutex};
+        if (auto it = index.find(key); it != index.end()) {
+            ++counters.hits;
+            entries.splice(entries.begin(), entries, it->second);
+            return std::static_pointer_cast<const Plan>(it->second->second);
+        }
+        ++counters.misses;
+    }
+
+    // Plan without holding the cache lock so that hits are not blocked by a slow planner.
+    auto plan = std::make_shared<const Plan>(Plan::dft(std::forward<Args>(args)...));
+
+    std::vector<std::shared_ptr<const void>> evicted;
+    std::lock_guard lock{mutex};
+    if (auto it = index.find(key); it != index.end()) {
+        // another thread planned the same descriptor in the meantime
+        entries.splice(entries.begin(), entries, it->second);
+        return std::static_pointer_cast<const Plan>(it->second->second);
+    }
+    if (max_size == 0) { return plan; }
+
+    entries.emplace_front(key, plan);
+    index.emplace(std::move(key), entries.begin());
+    trim(evicted);
+    return plan;
+}
+
+inline plan_cache_stats plan_cache::stats() const {
+    std::lock_guard lock{mutex};
+    auto result = counters;
+    result.size = entries.size();
+    result.capacity = max_size;
+    return result;
+}
+
+inline size_t plan_cache::capacity() const {
+    std::lock_guard lock{mutex};
+    return max_size;
+}
+
+inline void plan_cache::set_capacity(size_t capacity) {
+    std::vector<std::shared_ptr<const void>> evicted;
+    std::lock_guard lock{mutex};
+    max_size = capacity;
+    trim(evicted);
+}
+
+inline void plan_cache::clear() {
+    entry_list dropped;
+    std::lock_guard lock{mutex};
+    index.clear();
+    dropped.swap(entries);
+    counters = {};
+}
+
+inline void plan_cache::trim(std::vector<std::shared_ptr<const void>> &evicted) {
+    while (entries.size() > max_size) {
+        auto &last = entries.back();
+        evicted.push_back(std::move(last.second));
+        index.erase(last.first);
+        entries.pop_back();
+        ++counters.evictions;
+    }
+}
+
+} // namespace fftw
@@ -0,0 +1,230 @@
+#pragma once
+
+#include "basic_buffer.h"
+#include "basic_plan.h"
+#include "util.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fftw {
+
+/// A forward real transform, a chain of pointwise operations on the half spectrum, and the
+/// normalized inverse transform, executed as one call.
+///
+/// The spectrum lives in a buffer owned by the pipeline and reused by every call. All pointwise
+/// stages and the 1/N normalization are fused into a single pass over it: the spectrum is
+/// processed in blocks of block_size elements, and each block goes through every stage while it
+/// is in L1 cache. Plans and buffers are created at construction and stage filters are copied
+/// when the stage is added, so execution does not allocate (except for the one-time UNALIGNED
+/// fallback plan if the arrays passed to operator()(in, out) are aligned differently than the
+/// pipeline's own signal buffer).
+///
+/// The spectrum has the extents of the real shape with the last one replaced by n / 2 + 1, see
+/// spectrum_extents(); filters are row-major arrays of that many elements.
+///
+/// \code
+/// fftw::spectral_pipeline<2> lowpass{{512, 512}};
+/// lowpass.multiply(filter);
+/// lowpass(image.to_mdspan(), smoothed.to_mdspan());
+/// \endcode
+template <size_t D, class Real, class Complex = std::complex<Real>> class basic_spectral_pipeline {
+  public:
+    using real_t = Real;
+    using complex_t = Complex;
+    using extents_type = MDSPAN::dextents<size_t, D>;
+    using real_view = MDSPAN::mdspan<Real, extents_type>;
+    using complex_view = MDSPAN::mdspan<Complex, extents_type>;
+
+    /// Spectrum elements processed by all stages at once: 16 KiB in double precision, so a
+    /// block and the matching block of a filter fit into L1 cache together.
+    static constexpr size_t block_size = 1024;
+
+    /// A pointwise stage: transforms count spectrum elements starting at flat index offset.
+    using stage_t = std::function<void(Complex *block, size_t offset, size_t count)>;
+
+    explicit basic_spectral_pipeline(std::array<size_t, D> shape, Flags flags = MEASURE,
+                                     int threads = 1);
+
+    /// \defgroup{stages}
+    /// Stages run in the order they are added, returning *this for chaining.
+    /// Multiplies the spectrum by a filter, e.g. a kernel spectrum for convolution.
+    basic_spectral_pipeline &multiply(std::span<const Complex> filter);
+    /// Multiplies the spectrum by the complex conjugate of a filter, e.g. for cross-correlation.
+    basic_spectral_pipeline &conj_multiply(std::span<const Complex> filter);
+    /// Replaces every spectrum element x at flat index i by f(x, i).
+    template <typename F>
+        requires std::is_invocable_r_v<Complex, F &, Complex, size_t>
+    basic_spectral_pipeline &apply(F f);
+    /// Adds a stage that works on whole blocks, for operations that are vectorized by hand.
+    basic_spectral_pipeline &add_stage(stage_t stage);
+    /// Removes all stages; the pipeline then reproduces its input.
+    void clear_stages() { stages.clear(); }
+
+    /// Runs the pipeline in place on signal().
+    void operator()();
+
+    /// Runs the pipeline from in to out, which may be the same array.
+    void operator()(real_view in, real_view out);
+
+    template <class StorageIn, class StorageOut>
+    void operator()(
+        basic_mdbuffer<Real, extents_type, Complex, MDSPAN::layout_right, true, StorageIn> &in,
+        basic_mdbuffer<Real, extents_type, Complex, MDSPAN::layout_right, true, StorageOut> &out) {
+        (*this)(in.to_mdspan(), out.to_mdspan());
+    }
+
+    /// The pipeline's own signal buffer, processed by operator()().
+    [[nodiscard]] real_view signal() { return {signal_data.data(), real_extents}; }
+    /// The spectrum after the last execution, before the inverse transform.
+    [[nodiscard]] complex_view spectrum() { return {spectrum_data.data(), complex_extents}; }
+
+    [[nodiscard]] const extents_type &extents() const { return real_extents; }
+    [[nodiscard]] const extents_type &spectrum_extents() const { return complex_extents; }
+    [[nodiscard]] size_t spectrum_size() const { return spectrum_data.size(); }
+
+  private:
+    /// Runs every stage and the normalization on the spectrum, block by block.
+    void process_spectrum();
+
+    /// Copies a filter into memory owned by its stage.
+    std::shared_ptr<const basic_buffer<Real, Complex>> copy_filter(std::span<const Complex> filter);
+
+    extents_type real_extents;
+    extents_type complex_extents;
+    Real scale;
+
+    basic_rbuffer<Real, Complex> signal_data;
+    basic_buffer<Real, Complex> spectrum_data;
+    std::vector<stage_t> stages;
+
+    basic_plan_r2c<D, Real, Complex> forward;
+    basic_plan_c2r<D, Real, Complex> backward;
+};
+
+namespace detail {
+
+template <size_t D> MDSPAN::dextents<size_t, D> half_spectrum_extents(std::array<size_t, D> shape) {
+    shape[D - 1] = shape[D - 1] / 2 + 1;
+    return MDSPAN::dextents<size_t, D>{shape};
+}
+
+template <size_t D> size_t shape_size(const std::array<size_t, D> &shape) {
+    size_t n = 1;
+    for (auto extent : shape) {
+        if (extent == 0) { throw std::invalid_argument("empty pipeline shape"); }
+        n *= extent;
+    }
+    return n;
+}
+
+} // namespace detail
+
+template <size_t D, class Real, class Complex>
+basic_spectral_pipeline<D, Real, Complex>::basic_spectral_pipeline(std::array<size_t, D> shape,
+                                                                   Flags flags, int threads)
+    : real_extents(shape), complex_extents(detail::half_spectrum_extents(shape)),
+      scale(Real(1) / Real(detail::shape_size(shape))), signal_data(detail::shape_size(shape)),
+      spectrum_data(detail::shape_size(shape) / shape[D - 1] * (shape[D - 1] / 2 + 1)) {
+    forward = basic_plan_r2c<D, Real, Complex>::dft(signal(), spectrum(), flags, threads);
+    backward = basic_plan_c2r<D, Real, Complex>::dft(spectrum(), signal(), flags, threads);
+}
+
+template <size_t D, class Real, class Complex>
+auto basic_spectral_pipeline<D, Real, Complex>::copy_filter(std::span<const Complex> filter)
+    -> std::shared_ptr<const basic_buffer<Real, Complex>> {
+    if (filter.size() != spectrum_size()) {
+        throw std::invalid_argument("filter size does not match the spectrum size");
+    }
+    auto copy = std::make_shared<basic_buffer<Real, Complex>>(filter.size());
+    std::copy(filter.begin(), filter.end(), copy->begin());
+    return copy;
+}
+
+template <size_t D, class Real, class Complex>
+auto basic_spectral_pipeline<D, Real, Complex>::multiply(std::span<const Complex> filter)
+    -> basic_spectral_pipeline & {
+    return add_stage([h = copy_filter(filter)](Complex *block, size_t offset, size_t count) {
+        // written out on reals: std::complex multiplication checks for NaN and doesn't vectorize
+        auto *x = reinterpret_cast<Real *>(block);
+        const auto *y = reinterpret_cast<const Real *>(h->data() + offset);
+        for (size_t i = 0; i < count; ++i) {
+            Real re = x[2 * i] * y[2 * i] - x[2 * i + 1] * y[2 * i + 1];
+            Real im = x[2 * i] * y[2 * i + 1] + x[2 * i + 1] * y[2 * i];
+            x[2 * i] = re;
+            x[2 * i + 1] = im;
+        }
+    });
+}
+
+template <size_t D, class Real, class Complex>
+auto basic_spectral_pipeline<D, Real, Complex>::conj_multiply(std::span<const Complex> filter)
+    -> basic_spectral_pipeline & {
+    return add_stage([h = copy_filter(filter)](Complex *block, size_t offset, size_t count) {
+        auto *x = reinterpret_cast<Real *>(block);
+        const auto *y = reinterpret_cast<const Real *>(h->data() + offset);
+        for (size_t i = 0; i < count; ++i) {
+            Real re = x[2 * i] * y[2 * i] + x[2 * i + 1] * y[2 * i + 1];
+            Real im = x[2 * i + 1] * y[2 * i] - x[2 * i] * y[2 * i + 1];
+            x[2 * i] = re;
+            x[2 * i + 1] = im;
+        }
+    });
+}
+
+template <size_t D, class Real, class Complex>
+template <typename F>
+    requires std::is_invocable_r_v<Complex, F &, Complex, size_t>
+auto basic_spectral_pipeline<D, Real, Complex>::apply(F f) -> basic_spectral_pipeline & {
+    return add_stage([f = std::move(f)](Complex *block, size_t offset, size_t count) mutable {
+        for (size_t i = 0; i < count; ++i) {
+            block[i] = f(block[i], offset + i);
+        }
+    });
+}
+
+template <size_t D, class Real, class Complex>
+auto basic_spectral_pipeline<D, Real, Complex>::add_stage(stage_t stage)
+    -> basic_spectral_pipeline & {
+    if (!stage) { throw std::invalid_argument("empty pipeline stage"); }
+    stages.push_back(std::move(stage));
+    return *this;
+}
+
+template <size_t D, class Real, class Complex>
+void basic_spectral_pipeline<D, Real, Complex>::operator()() {
+    forward();
+    process_spectrum();
+    backward();
+}
+
+template <size_t D, class Real, class Complex>
+void basic_spectral_pipeline<D, Real, Complex>::operator()(real_view in, real_view out) {
+    if (in.extents() != real_extents || out.extents() != real_extents) {
+        throw std::invalid_argument("array extents do not match the pipeline shape");
+    }
+    forward(in, spectrum());
+    process_spectrum();
+    backward(spectrum(), out);
+}
+
+template <size_t D, class Real, class Complex>
+void basic_spectral_pipeline<D, Real, Complex>::process_spectrum() {
+    auto *data = spectrum_data.data();
+    for (size_t offset = 0; offset < spectrum_data.size(); offset += block_size) {
+        auto count = std::min(block_size, spectrum_data.size() - offset);
+        for (auto &stage : stages) {
+            stage(data + offset, offset, count);
+        }
+        detail::scale_reals(reinterpret_cast<Real *>(data + offset), 2 * count, scale);
+    }
+}
+
+} // namespace fftw
@@ -0,0 +1,254 @@
+#pragma once
+
+#include "basic_plan.h"
+#include "util.h"
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace fftw {
+
+namespace detail {
+
+/// Largest transform size handled by basic_static_plan; larger transforms go to FFTW.
+inline constexpr size_t max_static_size = 64;
+
+template <size_t N>
+inline constexpr bool is_small_static_size = N >= 2 && N <= max_static_size && (N & (N - 1)) == 0;
+
+/// Whether View is a one-dimensional mdspan (or mdarray) with a small, power-of-two static extent.
+template <typename View> constexpr bool has_small_static_extent() {
+    using T = std::remove_cvref_t<View>;
+    if constexpr (mdarray_like<T>) {
+        return has_small_static_extent<decltype(std::declval<T &>().to_mdspan())>();
+    } else if constexpr (mdspan_like<T>) {
+        if constexpr (T::rank() == 1) {
+            return is_small_static_size<T::static_extent(0)>;
+        } else {
+            return false;
+        }
+    } else {
+        return false;
+    }
+}
+
+/// sin and cos of x in [0, pi] by Taylor series, for twiddle factors computed at compile time
+/// (std::sin and std::cos are not constexpr before C++26).
+constexpr std::pair<long double, long double> constexpr_sincos(long double x) {
+    long double sin = 0.0L, cos = 0.0L, term = 1.0L;
+    for (int k = 0; k < 40; ++k) {
+        // term is x^k / k!
+        switch (k % 4) {
+        case 0:
+            cos += term;
+            break;
+        case 1:
+            sin += term;
+            break;
+        case 2:
+            cos -= term;
+            break;
+        default:
+            sin -= term;
+            break;
+        }
+        term *= x / (k + 1);
+    }
+    return {sin, cos};
+}
+
+/// Forward twiddle factors exp(-2 pi i k / N) for k < N / 2, as separate real and imaginary parts.
+template <class Real, size_t N> struct static_twiddles {
+    static constexpr auto table = [] {
+        constexpr long double pi = 3.141592653589793238462643383279502884L;
+        std::array<std::array<Real, N / 2>, 2> t{};
+        for (size_t k = 0; k < N / 2; ++k) {
+            auto [sin, cos] = constexpr_sincos(2.0L * pi * (long double)k / (long double)N);
+            t[0][k] = Real(cos);
+            t[1][k] = Real(-sin);
+        }
+        return t;
+    }();
+};
+
+template <size_t N> constexpr std::array<size_t, N> bit_reversal() {
+    std::array<size_t, N> rev{};
+    for (size_t i = 0; i < N; ++i) {
+        for (size_t bit = 1, r = N >> 1; bit < N; bit <<= 1, r >>= 1) {
+            if ((i & bit) != 0) { rev[i] |= r; }
+        }
+    }
+    return rev;
+}
+
+/// One radix-2 stage combining pairs of transforms of size Half. All loop bounds are constants,
+/// so the compiler unrolls and vectorizes them over the split real/imaginary arrays.
+template <size_t N, size_t Half, bool Inverse, class Real>
+inline void static_butterflies(std::array<Real, N> &re, std::array<Real, N> &im) {
+    constexpr auto &w = static_twiddles<Real, N>::table;
+    constexpr size_t step = N / (2 * Half);
+    for (size_t start = 0; start < N; start += 2 * Half) {
+        for (size_t k = 0; k < Half; ++k) {
+            Real w_re = w[0][k * step];
+            Real w_im = Inverse ? -w[1][k * step] : w[1][k * step];
+            size_t a = start + k, b = a + Half;
+            Real t_re = re[b] * w_re - im[b] * w_im;
+            Real t_im = re[b] * w_im + im[b] * w_re;
+            re[b] = re[a] - t_re;
+            im[b] = im[a] - t_im;
+            re[a] += t_re;
+            im[a] += t_im;
+        }
+    }
+}
+
+/// Unnormalized DFT of size N from in to out (which may alias), multiplied by scale: iterative
+/// radix-2 decimation in time on a copy in registers/stack, one stage per template instance.
+template <size_t N, bool Inverse, class Real, class In, class Out>
+inline void static_dft(const In &in, const Out &out, Real scale) {
+    constexpr auto rev = bit_reversal<N>();
+    alignas(64) std::array<Real, N> re, im;
+    for (size_t i = 0; i < N; ++i) {
+        auto x = in(rev[i]);
+        re[i] = x.real();
+        im[i] = x.imag();
+    }
+    [&]<size_t... S>(std::index_sequence<S...>) {
+        (static_butterflies<N, (size_t(1) << S), Inverse>(re, im), ...);
+    }(std::make_index_sequence<std::countr_zero(N)>{});
+    for (size_t i = 0; i < N; ++i) {
+        out(i) = {re[i] * scale, im[i] * scale};
+    }
+}
+
+} // namespace detail
+
+/// A one-dimensional c2c transform of a small, power-of-two size N known at compile time
+/// (2 <= N <= 64), for arrays with static extents such as
+/// `mdspan<std::complex<double>, extents<size_t, 16>>`.
+///
+/// For such sizes, the per-call overhead of fftw_execute_dft dominates the transform itself.
+/// basic_static_plan computes it with butterflies generated at compile time instead: twiddle
+/// factors and the bit-reversal permutation are constexpr tables, and there is no planner and no
+/// dispatch through function pointers. Use basic_static_dft_plan to pick basic_static_plan or
+/// basic_plan depending on the view type.
+///
+/// The interface mirrors basic_plan: dft() stores the arrays for operator()(), and
+/// operator()(in, out) executes on other arrays of the same size, with any layout.
+template <size_t N, class Real, class Complex = std::complex<Real>> class basic_static_plan {
+    static_assert(detail::is_small_static_size<N>,
+                  "basic_static_plan supports powers of two from 2 to 64");
+
+  public:
+    using real_t = Real;
+    using complex_t = Complex;
+    using view_type = MDSPAN::mdspan<Complex, MDSPAN::extents<size_t, N>>;
+
+    static constexpr size_t size = N;
+
+    basic_static_plan() = default;
+
+    /// Executes the plan with the arrays provided initially.
+    void operator()() const {
+        if (!in_view.data_handle()) { throw std::logic_error("empty plan"); }
+        (*this)(in_view, out_view);
+    }
+
+    /// Executes the plan on other arrays; in and out may be the same array.
+    template <typename ViewIn, typename ViewOut> void operator()(ViewIn &&in, ViewOut &&out) const {
+        static_assert(detail::has_small_static_extent<ViewIn>() &&
+                          detail::has_small_static_extent<ViewOut>(),
+                      "basic_static_plan needs views with a static extent");
+        if constexpr (detail::mdarray_like<std::remove_cvref_t<ViewIn>>) {
+            (*this)(in.to_mdspan(), std::forward<ViewOut>(out));
+        } else if constexpr (detail::mdarray_like<std::remove_cvref_t<ViewOut>>) {
+            (*this)(std::forward<ViewIn>(in), out.to_mdspan());
+        } else {
+            static_assert(std::remove_cvref_t<ViewIn>::static_extent(0) == N &&
+                              std::remove_cvref_t<ViewOut>::static_extent(0) == N,
+                          "view size does not match the plan size");
+            if (direction == FORWARD) {
+                detail::static_dft<N, false>(in, out, output_scale);
+            } else {
+                detail::static_dft<N, true>(in, out, output_scale);
+            }
+        }
+    }
+
+    /// Same as basic_plan::normalize(); the scaling is applied while the output is written.
+    void normalize(normalization mode) {
+        switch (mode) {
+        case normalization::NONE:
+            output_scale = Real(1);
+            break;
+        case normalization::BACKWARD:
+            output_scale = direction == BACKWARD ? Real(1) / Real(N) : Real(1);
+            break;
+        case normalization::FORWARD:
+            output_scale = direction == FORWARD ? Real(1) / Real(N) : Real(1);
+            break;
+        case normalization::ORTHO:
+            output_scale = Real(1 / std::sqrt((long double)N));
+            break;
+        }
+    }
+
+    [[nodiscard]] Real scale_factor() const { return output_scale; }
+
+    /// \defgroup{planning utilities}
+    /// Flags and threads are accepted for compatibility with basic_plan::dft and ignored: there is
+    /// nothing to plan, and the arrays are never touched.
+    template <typename ViewIn, typename ViewOut>
+    static auto dft(ViewIn &&in, ViewOut &&out, Direction direction, Flags flags = ESTIMATE,
+                    int threads = 1) -> basic_static_plan {
+        (void)flags;
+        (void)threads;
+        basic_static_plan plan;
+        plan.in_view = as_view(in);
+        plan.out_view = as_view(out);
+        plan.direction = direction;
+        return plan;
+    }
+
+  private:
+    template <typename View> static view_type as_view(View &&view) {
+        if constexpr (detail::mdarray_like<std::remove_cvref_t<View>>) {
+            return as_view(view.to_mdspan());
+        } else {
+            static_assert(std::is_convertible_v<std::remove_cvref_t<View>, view_type>,
+                          "basic_static_plan::dft needs contiguous views with a static extent");
+            return view;
+        }
+    }
+
+    view_type in_view{};
+    view_type out_view{};
+    Direction direction{FORWARD};
+    Real output_scale{1};
+};
+
+namespace detail {
+
+template <typename View, class Real, class Complex, bool Small = has_small_static_extent<View>()>
+struct select_dft_plan {
+    using type = basic_plan<std::remove_cvref_t<View>::rank(), Real, Complex>;
+};
+
+template <typename View, class Real, class Complex>
+struct select_dft_plan<View, Real, Complex, true> {
+    using view_type = decltype(rebindable(std::declval<std::remove_cvref_t<View> &>()));
+    using type = basic_static_plan<view_type::static_extent(0), Real, Complex>;
+};
+
+} // namespace detail
+
+/// basic_static_plan for views with a small static extent, basic_plan (FFTW) otherwise. Both are
+/// created with dft(in, out, direction, flags) and executed with operator()().
+template <typename View, class Real, class Complex = std::complex<Real>>
+using basic_static_dft_plan = typename detail::select_dft_plan<View, Real, Complex>::type;
+
+} // namespace fftw
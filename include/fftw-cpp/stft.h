@@ -0,0 +1,195 @@
+#pragma once
+
+#include "basic_batched_plan.h"
+#include "basic_buffer.h"
+#include "util.h"
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace fftw {
+
+/// Short-time Fourier transform of a real signal over overlapping, windowed frames.
+/// Frame f covers the samples [f * hop, f * hop + window size); it is multiplied by the window
+/// while it is copied into the frame batch, zero-padded to fft_size(), and frames_per_batch()
+/// frames at a time are transformed by one batched r2c plan. All buffers and plans are created
+/// at construction, so forward() and inverse() don't allocate.
+///
+/// The spectrogram has one row per frame and fft_size() / 2 + 1 columns. Full batches are
+/// transformed straight into its rows; only the last, partial batch goes through scratch memory.
+///
+/// \code
+/// fftw::stft analysis{hann, 256};
+/// fftw::mdbuffer<2> spectrogram{analysis.frames(signal.size()), analysis.bins()};
+/// analysis.forward(signal, spectrogram);
+/// \endcode
+template <class Real, class Complex = std::complex<Real>> class basic_stft {
+  public:
+    using real_t = Real;
+    using complex_t = Complex;
+    using spectrogram_view = MDSPAN::mdspan<Complex, MDSPAN::dextents<size_t, 2u>>;
+
+    /// An fft_size of 0 uses the window size; a larger size zero-pads every frame.
+    basic_stft(std::span<const Real> window, size_t hop, size_t fft_size = 0,
+               size_t frames_per_batch = 32, Flags flags = MEASURE, int threads = 1);
+
+    /// The number of full frames in a signal of this length.
+    [[nodiscard]] size_t frames(size_t signal_length) const {
+        return signal_length < win.size() ? 0 : (signal_length - win.size()) / hop_size + 1;
+    }
+
+    /// The length of the signal covered by this many frames.
+    [[nodiscard]] size_t signal_length(size_t frames) const {
+        return frames == 0 ? 0 : (frames - 1) * hop_size + win.size();
+    }
+
+    [[nodiscard]] size_t window_size() const { return win.size(); }
+    [[nodiscard]] size_t hop() const { return hop_size; }
+    [[nodiscard]] size_t fft_size() const { return n; }
+    /// Frequency bins per frame, the number of columns of a spectrogram.
+    [[nodiscard]] size_t bins() const { return n / 2 + 1; }
+    [[nodiscard]] size_t frames_per_batch() const { return batch; }
+
+    /// Computes the spectrogram of every full frame of the signal.
+    /// The spectrogram needs at least frames(signal.size()) rows and exactly bins() columns.
+    void forward(std::span<const Real> signal, spectrogram_view spectrogram);
+
+    template <class Storage>
+    void forward(std::span<const Real> signal,
+                 basic_mdbuffer<Real, MDSPAN::dextents<size_t, 2u>, Complex, MDSPAN::layout_right,
+                                false, Storage> &spectrogram) {
+        forward(signal, spectrogram.to_mdspan());
+    }
+
+    /// Reconstructs a signal from the rows of a spectrogram by weighted overlap-add:
+    /// each inverse-transformed frame is multiplied by the window again, and every sample is
+    /// divided by the sum of the squared windows overlapping it. This inverts forward() wherever
+    /// that sum is not zero; samples no window covers are set to zero.
+    /// The signal needs room for signal_length(spectrogram.extent(0)) samples.
+    void inverse(spectrogram_view spectrogram, std::span<Real> signal);
+
+    template <class Storage>
+    void inverse(basic_mdbuffer<Real, MDSPAN::dextents<size_t, 2u>, Complex, MDSPAN::layout_right,
+                                false, Storage> &spectrogram,
+                 std::span<Real> signal) {
+        inverse(spectrogram.to_mdspan(), signal);
+    }
+
+  private:
+    using frames_view = MDSPAN::mdspan<Real, MDSPAN::dextents<size_t, 2u>>;
+
+    frames_view frame_batch(size_t count) { return frames_view{frame_data.data(), count, n}; }
+    spectrogram_view scratch_batch() { return spectrogram_view{scratch.data(), batch, bins()}; }
+
+    std::vector<Real> win;
+    size_t hop_size;
+    size_t n;
+    size_t batch;
+
+    basic_rbuffer<Real, Complex> frame_data; ///< batch frames of n samples
+    basic_buffer<Real, Complex> scratch;     ///< batch spectra of bins() values
+
+    basic_batched_plan_r2c<1u, Real, Complex> r2c;
+    basic_batched_plan_c2r<1u, Real, Complex> c2r;
+};
+
+template <class Real, class Complex>
+basic_stft<Real, Complex>::basic_stft(std::span<const Real> window, size_t hop, size_t fft_size,
+                                      size_t frames_per_batch, Flags flags, int threads)
+    : win(window.begin(), window.end()), hop_size(hop),
+      n(fft_size != 0 ? fft_size : window.size()), batch(frames_per_batch),
+      frame_data(batch * n), scratch(batch * (n / 2 + 1)) {
+    if (window.empty()) { throw std::invalid_argument("empty STFT window"); }
+    if (hop == 0) { throw std::invalid_argument("STFT hop must be positive"); }
+    if (n < window.size()) { throw std::invalid_argument("FFT size smaller than the window"); }
+    if (batch == 0) { throw std::invalid_argument("STFT batch must hold at least one frame"); }
+
+    r2c = basic_batched_plan_r2c<1u, Real, Complex>::dft(frame_batch(batch), scratch_batch(),
+                                                          flags, threads);
+    c2r = basic_batched_plan_c2r<1u, Real, Complex>::dft(scratch_batch(), frame_batch(batch),
+                                                          flags, threads);
+}
+
+template <class Real, class Complex>
+void basic_stft<Real, Complex>::forward(std::span<const Real> signal,
+                                        spectrogram_view spectrogram) {
+    auto count = frames(signal.size());
+    if (spectrogram.extent(0) < count || spectrogram.extent(1) != bins()) {
+        throw std::invalid_argument("spectrogram extents don't match the STFT");
+    }
+
+    for (size_t first = 0; first < count; first += batch) {
+        auto frames_in_batch = std::min(batch, count - first);
+
+        // Windowing is fused into framing; the zero padding beyond the window is rewritten every
+        // time, because execution on a partial batch leaves stale frames behind.
+        for (size_t b = 0; b < frames_in_batch; ++b) {
+            auto *frame = frame_data.data() + b * n;
+            const auto *samples = signal.data() + (first + b) * hop_size;
+            for (size_t i = 0; i < win.size(); ++i) {
+                frame[i] = samples[i] * win[i];
+            }
+            std::fill(frame + win.size(), frame + n, Real{0});
+        }
+
+        if (frames_in_batch == batch) {
+            r2c(frame_batch(batch),
+                spectrogram_view{&spectrogram(first, 0), batch, bins()});
+        } else {
+            r2c(frame_batch(batch), scratch_batch());
+            std::copy_n(scratch.data(), frames_in_batch * bins(), &spectrogram(first, 0));
+        }
+    }
+}
+
+template <class Real, class Complex>
+void basic_stft<Real, Complex>::inverse(spectrogram_view spectrogram, std::span<Real> signal) {
+    auto count = spectrogram.extent(0);
+    if (spectrogram.extent(1) != bins()) {
+        throw std::invalid_argument("spectrogram extents don't match the STFT");
+    }
+    auto length = signal_length(count);
+    if (signal.size() < length) { throw std::invalid_argument("signal shorter than the frames"); }
+
+    std::fill(signal.begin(), signal.begin() + length, Real{0});
+    auto scale = Real{1} / Real(n);
+    for (size_t first = 0; first < count; first += batch) {
+        auto frames_in_batch = std::min(batch, count - first);
+
+        // c2r overwrites its input, so the caller's spectrogram is copied first.
+        std::copy_n(&spectrogram(first, 0), frames_in_batch * bins(), scratch.data());
+        std::fill(scratch.data() + frames_in_batch * bins(), scratch.data() + scratch.size(),
+                  Complex{});
+        c2r();
+
+        for (size_t b = 0; b < frames_in_batch; ++b) {
+            const auto *frame = frame_data.data() + b * n;
+            auto *samples = signal.data() + (first + b) * hop_size;
+            for (size_t i = 0; i < win.size(); ++i) {
+                samples[i] += frame[i] * win[i] * scale;
+            }
+        }
+    }
+
+    // The frames covering sample t are those with t - window size < f * hop <= t.
+    auto peak = Real{0};
+    for (auto w : win) {
+        peak = std::max(peak, w * w);
+    }
+    auto threshold = peak * std::numeric_limits<Real>::epsilon();
+    for (size_t t = 0; t < length; ++t) {
+        auto last = std::min(t / hop_size, count - 1);
+        auto first = t < win.size() ? size_t{0} : (t - win.size()) / hop_size + 1;
+        auto norm = Real{0};
+        for (auto f = first; f <= last; ++f) {
+            auto w = win[t - f * hop_size];
+            norm += w * w;
+        }
+        signal[t] = norm > threshold ? signal[t] / norm : Real{0};
+    }
+}
+
+} // namespace fftw
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "basic_plan.h"
+#include "util.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace fftw {
+
+/// How upgradable_plan creates its final plan.
+struct upgrade_options {
+    Flags flags{MEASURE}; ///< rigor (and modifiers) of the final plan, e.g. MEASURE or PATIENT
+    double time_limit{FFTW_NO_TIMELIMIT}; ///< seconds the planner may spend, see planner_time_limit
+    int threads{1};
+};
+
+namespace detail {
+
+/// Bytes spanned by a view, including gaps of strided layouts.
+template <typename View> size_t span_bytes(const View &view) {
+    if constexpr (mdspan_like<View>) {
+        return size_t(view.mapping().required_span_size()) * sizeof(typename View::element_type);
+    } else {
+        return view.size() * sizeof(typename View::element_type);
+    }
+}
+
+/// Scratch memory with the same alignment class as `like`, so that a plan created on it can be
+/// executed on `like` without the UNALIGNED fallback.
+template <std::floating_point Real> class scratch_array {
+  public:
+    static constexpr size_t max_alignment = 64;
+
+    scratch_array(size_t bytes, const void *like)
+        : base(fftw_types<Real>::malloc(bytes + max_alignment), fftw_types<Real>::free) {
+        if (!base) { throw std::bad_alloc(); }
+        auto offset = reinterpret_cast<std::uintptr_t>(like) % max_alignment;
+        ptr = static_cast<char *>(base.get()) + offset;
+    }
+
+    [[nodiscard]] void *data() const { return ptr; }
+
+  private:
+    std::unique_ptr<void, fftw_free_t> base;
+    void *ptr;
+};
+
+} // namespace detail
+
+/// A plan that can be used right away and becomes faster later.
+/// The constructor creates an ESTIMATE plan, which takes microseconds and never touches the
+/// arrays, and starts planning the same transform with upgrade_options::flags (MEASURE, PATIENT)
+/// in the background, on scratch arrays of the same shape and alignment class, so the caller's
+/// data is never overwritten by the planner. Once that plan is ready, it is swapped in atomically:
+/// executions that already started finish on the ESTIMATE plan, later ones use the final plan.
+/// Executions never wait for the planner: the ESTIMATE plan is created with UNALIGNED, so it
+/// runs on arrays of any alignment without planning again.
+///
+/// Plan is any plan class with a static dft factory, e.g. fftw::plan<2>; the arguments are those of
+/// Plan::dft without the flags and thread count.
+///
+/// \code
+/// fftw::upgradable_plan<fftw::plan<2>> p{{fftw::PATIENT, 10.0}, in.to_mdspan(),
+///                                        out.to_mdspan(), fftw::FORWARD};
+/// p(in.to_mdspan(), out.to_mdspan()); // ESTIMATE at first, PATIENT once planned
+/// \endcode
+///
+/// Background planning holds the planner lock (detail::planner_mutex()) for its whole duration,
+/// like any other plan creation; use time_limit to bound it. The destructor waits for it.
+template <class Plan> class upgradable_plan {
+  public:
+    using plan_type = Plan;
+    using real_t = typename Plan::real_t;
+
+    template <typename In, typename Out, typename... Args>
+    upgradable_plan(upgrade_options options, In &&in, Out &&out, const Args &...args)
+        : state(std::make_unique<shared_state>()) {
+        // UNALIGNED: new-array executions on arrays of any alignment class use this plan
+        // directly instead of creating a fallback plan, which would need the planner lock the
+        // background planning holds.
+        auto initial_flags = ESTIMATE | UNALIGNED;
+        state->initial = std::make_shared<const Plan>(
+            Plan::dft(in, out, args..., initial_flags, options.threads));
+        state->current.store(state->initial);
+
+        auto in_proto = detail::rebindable(in);
+        auto out_proto = detail::rebindable(out);
+        state->execute_original = [in_proto, out_proto](const Plan &plan) mutable {
+            plan(in_proto, out_proto);
+        };
+
+        auto *s = state.get();
+        state->upgrade = std::async(std::launch::async, [s, in_proto, out_proto, args...,
+                                                         options]() mutable {
+            const void *in_ptr = detail::data_of(in_proto);
+            const void *out_ptr = detail::data_of(out_proto);
+            auto in_bytes = detail::span_bytes(in_proto), out_bytes = detail::span_bytes(out_proto);
+
+            // in-place transforms are planned in place
+            detail::scratch_array<real_t> in_scratch{std::max(in_bytes, out_bytes), in_ptr};
+            std::unique_ptr<detail::scratch_array<real_t>> out_scratch;
+            if (in_ptr != out_ptr) {
+                out_scratch = std::make_unique<detail::scratch_array<real_t>>(out_bytes, out_ptr);
+            }
+            auto in_view = detail::rebind(in_proto, in_scratch.data());
+            auto out_view =
+                detail::rebind(out_proto, out_scratch ? out_scratch->data() : in_scratch.data());
+
+            planner_time_limit limit{options.time_limit};
+            auto final_plan = std::make_shared<const Plan>(
+                Plan::dft(in_view, out_view, args..., options.flags, options.threads));
+            s->current.store(std::move(final_plan), std::memory_order_release);
+            s->upgraded.store(true, std::memory_order_release);
+        }).share();
+    }
+
+    upgradable_plan(upgradable_plan &&) noexcept = default;
+    upgradable_plan &operator=(upgradable_plan &&) noexcept = default;
+
+    /// Executes the current plan on the arrays passed to the constructor.
+    void operator()() const { state->execute_original(*current()); }
+
+    /// Executes the current plan on other arrays, like Plan::operator()(in, out).
+    template <typename In, typename Out> void operator()(In &&in, Out &&out) const {
+        (*current())(std::forward<In>(in), std::forward<Out>(out));
+    }
+
+    /// The plan executions use right now, e.g. for introspection.
+    [[nodiscard]] std::shared_ptr<const Plan> current() const {
+        return state->current.load(std::memory_order_acquire);
+    }
+
+    /// Whether the final plan has been swapped in.
+    [[nodiscard]] bool upgraded() const { return state->upgraded.load(std::memory_order_acquire); }
+
+    /// Waits for background planning; rethrows its error, e.g. from WISDOM_ONLY without wisdom.
+    /// If planning failed, the ESTIMATE plan stays in use.
+    void wait() const { state->upgrade.get(); }
+
+  private:
+    struct shared_state {
+        // Superseded plans stay alive until the upgradable plan is destroyed, so executing threads
+        // never destroy plans (which would take the planner lock).
+        std::shared_ptr<const Plan> initial;
+        std::atomic<std::shared_ptr<const Plan>> current;
+        std::atomic<bool> upgraded{false};
+        std::function<void(const Plan &)> execute_original;
+        std::shared_future<void> upgrade;
+
+        ~shared_state() {
+            if (upgrade.valid()) { upgrade.wait(); }
+        }
+    };
+
+    std::unique_ptr<shared_state> state;
+};
+
+} // namespace fftw
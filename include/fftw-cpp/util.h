@@ -4,7 +4,10 @@
 #include <concepts>
 #include <cstddef>
 #include <fftw3.h>
+#include <mutex>
 #include <numeric>
+#include <stdexcept>
+#include <utility>
 
 namespace fftw {
 
@@ -14,29 +17,258 @@ enum Direction {
     BACKWARD = FFTW_BACKWARD,
 };
 
-enum Flags {
+// unsigned like FFTW's flags, so that every combination of them, including flags of other FFTW
+// libraries such as fftw3-mpi (up to 1U << 30), is a valid value
+enum Flags : unsigned {
     ESTIMATE = FFTW_ESTIMATE,
     MEASURE = FFTW_MEASURE,
     PATIENT = FFTW_PATIENT,
+    /// The plan can be executed on arrays of any alignment, at the cost of SIMD
+    UNALIGNED = FFTW_UNALIGNED,
+    /// Only plan if wisdom is available, never measure (the arrays are not touched)
+    WISDOM_ONLY = FFTW_WISDOM_ONLY,
+};
+
+/// Combines a planning rigor with modifiers, e.g. `MEASURE | UNALIGNED`.
+constexpr Flags operator|(Flags a, Flags b) { return Flags(unsigned(a) | unsigned(b)); }
+
+/// Which transforms of a forward/backward pair are scaled, see basic_plan::normalize().
+/// FFTW computes unnormalized transforms: a forward and a backward transform of N elements
+/// multiply the data by N.
+enum class normalization {
+    NONE,     ///< no scaling, FFTW's convention
+    BACKWARD, ///< the backward transform is scaled by 1/N, the usual inverse
+    FORWARD,  ///< the forward transform is scaled by 1/N
+    ORTHO,    ///< both transforms are scaled by 1/sqrt(N), which makes them unitary
 };
 
 using std::size_t;
 
 namespace detail {
-// TODO specialize for float, long double, __float128
+/// Maps a real type to the types and functions of the matching FFTW library:
+/// fftw_ (double), fftwf_ (float), fftwl_ (long double) and fftwq_ (__float128).
+/// Only the precisions linked in CMake (FFTW_CPP_FLOAT etc.) can be used, double always is.
 template <std::floating_point Real> struct fftw_types;
 
-template <> struct fftw_types<double> {
-    using complex = fftw_complex;
-    using plan = fftw_plan;
-};
+#define FFTW_CPP_DEFINE_TYPES(R, X)                                                                \
+    template <> struct fftw_types<R> {                                                             \
+        using complex = X##complex;                                                                \
+        using plan = X##plan;                                                                      \
+        using iodim64 = X##iodim64;                                                                \
+        using r2r_kind = X##r2r_kind;                                                              \
+                                                                                                   \
+        static constexpr auto malloc = &X##malloc;                                                 \
+        static constexpr auto free = &X##free;                                                     \
+        static constexpr auto alignment_of = &X##alignment_of;                                     \
+                                                                                                   \
+        static constexpr auto plan_dft_1d = &X##plan_dft_1d;                                       \
+        static constexpr auto plan_dft = &X##plan_dft;                                             \
+        static constexpr auto plan_dft_r2c = &X##plan_dft_r2c;                                     \
+        static constexpr auto plan_dft_c2r = &X##plan_dft_c2r;                                     \
+        static constexpr auto plan_many_dft = &X##plan_many_dft;                                   \
+        static constexpr auto plan_many_dft_r2c = &X##plan_many_dft_r2c;                           \
+        static constexpr auto plan_many_dft_c2r = &X##plan_many_dft_c2r;                           \
+        static constexpr auto plan_guru64_dft = &X##plan_guru64_dft;                               \
+        static constexpr auto plan_guru64_dft_r2c = &X##plan_guru64_dft_r2c;                       \
+        static constexpr auto plan_guru64_dft_c2r = &X##plan_guru64_dft_c2r;                       \
+        static constexpr auto plan_r2r = &X##plan_r2r;                                             \
+        static constexpr auto plan_guru64_r2r = &X##plan_guru64_r2r;                               \
+        static constexpr auto destroy_plan = &X##destroy_plan;                                     \
+                                                                                                   \
+        static constexpr auto execute = &X##execute;                                               \
+        static constexpr auto execute_dft = &X##execute_dft;                                       \
+        static constexpr auto execute_dft_r2c = &X##execute_dft_r2c;                               \
+        static constexpr auto execute_dft_c2r = &X##execute_dft_c2r;                               \
+        static constexpr auto execute_r2r = &X##execute_r2r;                                       \
+                                                                                                   \
+        static constexpr auto flops = &X##flops;                                                   \
+        static constexpr auto cost = &X##cost;                                                     \
+        static constexpr auto estimate_cost = &X##estimate_cost;                                   \
+        static constexpr auto sprint_plan = &X##sprint_plan;                                       \
+                                                                                                   \
+        static constexpr auto import_wisdom_from_filename = &X##import_wisdom_from_filename;       \
+        static constexpr auto import_wisdom_from_string = &X##import_wisdom_from_string;           \
+        static constexpr auto import_system_wisdom = &X##import_system_wisdom;                     \
+        static constexpr auto export_wisdom_to_filename = &X##export_wisdom_to_filename;           \
+        static constexpr auto export_wisdom_to_string = &X##export_wisdom_to_string;               \
+        static constexpr auto forget_wisdom = &X##forget_wisdom;                                   \
+                                                                                                   \
+        static constexpr auto set_timelimit = &X##set_timelimit;                                   \
+        static constexpr auto init_threads = &X##init_threads;                                     \
+        static constexpr auto cleanup_threads = &X##cleanup_threads;                               \
+        static constexpr auto plan_with_nthreads = &X##plan_with_nthreads;                         \
+    }
+
+FFTW_CPP_DEFINE_TYPES(double, fftw_);
+#ifdef FFTW_CPP_FLOAT
+FFTW_CPP_DEFINE_TYPES(float, fftwf_);
+#endif
+#ifdef FFTW_CPP_LONG_DOUBLE
+FFTW_CPP_DEFINE_TYPES(long double, fftwl_);
+#endif
+#ifdef FFTW_CPP_QUAD
+FFTW_CPP_DEFINE_TYPES(__float128, fftwq_);
+#endif
+
+#undef FFTW_CPP_DEFINE_TYPES
 
 template <std::floating_point Real> using fftw_complex_t = typename fftw_types<Real>::complex;
 
 template <std::floating_point Real> using fftw_plan_t = typename fftw_types<Real>::plan;
 
+/// The signature of fftw_free, shared by all precisions.
+using fftw_free_t = void (*)(void *);
+
+template <typename T>
+concept mdspan_like = requires(const T &t) {
+    t.mapping();
+    t.data_handle();
+};
+
+template <typename T>
+concept mdarray_like = requires(const T &t) { t.to_mdspan(); };
+
+template <typename T>
+concept buffer_like = !mdarray_like<T> && requires(T &t) {
+    t.unwrap();
+    t.size();
+};
+
+/// The FFTW planner is not thread-safe: every call that creates or destroys a plan must hold this
+/// mutex. Executing an existing plan does not require it.
+inline std::mutex &planner_mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+/// The alignment class of any array (see fftw_alignment_of); 0 means SIMD-aligned.
+template <std::floating_point Real> int alignment_of(const void *ptr) {
+    return fftw_types<Real>::alignment_of(reinterpret_cast<Real *>(const_cast<void *>(ptr)));
+}
+
+template <std::floating_point Real> void destroy_plan(fftw_plan_t<Real> p) {
+    std::lock_guard lock{planner_mutex()};
+    fftw_types<Real>::destroy_plan(p);
+}
+
+/// Calls f with a value of every real type whose FFTW library is linked in CMake.
+template <typename F> void for_each_precision(F f) {
+    f(0.0);
+#ifdef FFTW_CPP_FLOAT
+    f(0.0f);
+#endif
+#ifdef FFTW_CPP_LONG_DOUBLE
+    f(0.0L);
+#endif
+#ifdef FFTW_CPP_QUAD
+    f(__float128(0));
+#endif
+}
+
+#ifdef FFTW_CPP_THREADS
+/// Whether the FFTW threads library of a precision is initialized. Must hold planner_mutex().
+template <std::floating_point Real> bool &threads_initialized() {
+    static bool initialized = false;
+    return initialized;
+}
+
+/// Initializes the FFTW threads library of a precision, unless it already is.
+/// Must hold planner_mutex().
+template <std::floating_point Real> void init_threads() {
+    if (threads_initialized<Real>()) { return; }
+    if (fftw_types<Real>::init_threads() == 0) {
+        throw std::runtime_error("failed to initialize FFTW threads");
+    }
+    threads_initialized<Real>() = true;
+}
+
+/// Releases the FFTW threads library of a precision; the next plan initializes it again.
+/// Must hold planner_mutex().
+template <std::floating_point Real> void cleanup_threads() {
+    if (!threads_initialized<Real>()) { return; }
+    fftw_types<Real>::cleanup_threads();
+    threads_initialized<Real>() = false;
+}
+#endif
+
+/// The planner time limit of the calling thread in seconds, see planner_time_limit.
+inline double &plan_time_limit() {
+    thread_local double limit = FFTW_NO_TIMELIMIT;
+    return limit;
+}
+
+/// Sets the number of threads and the time limit used by the next plan. Must hold
+/// planner_mutex(). Without the threads library, every plan is single-threaded and the count is
+/// ignored.
+template <std::floating_point Real = double> void plan_with_threads(int threads) {
+    if (threads < 1) { throw std::invalid_argument("thread count must be positive"); }
+#ifdef FFTW_CPP_THREADS
+    init_threads<Real>();
+    fftw_types<Real>::plan_with_nthreads(threads);
+#endif
+    fftw_types<Real>::set_timelimit(plan_time_limit());
+}
+
 } // namespace detail
 
+/// Whether fftw-cpp was built against a multithreaded FFTW library (FFTW_CPP_THREADS in CMake).
+constexpr bool threads_supported() {
+#ifdef FFTW_CPP_THREADS
+    return true;
+#else
+    return false;
+#endif
+}
+
+/// Scopes the FFTW threads library to the lifetime of this object.
+/// Threads are initialized lazily by the first plan with more than one thread anyway, so this is
+/// only needed to release the threads' resources at a defined point. All plans (including those in
+/// plan_cache::global()) must be destroyed before this object is; plans created afterwards, or by
+/// another threads_guard, initialize the threads library again. The guard initializes and cleans
+/// up every precision linked in CMake.
+class threads_guard {
+  public:
+    threads_guard() {
+#ifdef FFTW_CPP_THREADS
+        std::lock_guard lock{detail::planner_mutex()};
+        detail::for_each_precision([]<class Real>(Real) { detail::init_threads<Real>(); });
+#endif
+    }
+
+    threads_guard(const threads_guard &) = delete;
+    threads_guard &operator=(const threads_guard &) = delete;
+
+    ~threads_guard() {
+#ifdef FFTW_CPP_THREADS
+        std::lock_guard lock{detail::planner_mutex()};
+        detail::for_each_precision([]<class Real>(Real) { detail::cleanup_threads<Real>(); });
+#endif
+    }
+};
+
+/// Bounds the time the planner may spend on each plan created by the calling thread during the
+/// lifetime of this object, in seconds (fftw_set_timelimit). The planner then returns the best
+/// plan found so far. FFTW's limit is global, so it is set for every plan under the planner lock
+/// and other threads keep planning without a limit.
+class planner_time_limit {
+  public:
+    explicit planner_time_limit(double seconds)
+        : previous(std::exchange(detail::plan_time_limit(), seconds)) {
+        if (!(seconds >= 0.0) && seconds != FFTW_NO_TIMELIMIT) {
+            detail::plan_time_limit() = previous;
+            throw std::invalid_argument("time limit must be non-negative");
+        }
+    }
+
+    planner_time_limit(const planner_time_limit &) = delete;
+    planner_time_limit &operator=(const planner_time_limit &) = delete;
+
+    ~planner_time_limit() { detail::plan_time_limit() = previous; }
+
+  private:
+    double previous;
+};
+
 template <bool IsReal, class Real, class Complex>
 using underlying_element_type = std::conditional_t<IsReal, Real, detail::fftw_complex_t<Real>>;
 
@@ -0,0 +1,233 @@
+#pragma once
+
+#include "util.h"
+#include <filesystem>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace fftw {
+
+/// Free functions around FFTW's global wisdom.
+/// Wisdom is shared planner state, so every function here holds detail::planner_mutex().
+/// Importing wisdom merges it into the wisdom already accumulated by the process.
+/// Every precision has its own wisdom, selected with the Real template parameter.
+namespace wisdom {
+
+/// Merges wisdom from a file. Returns false if the file cannot be read or is not valid wisdom.
+template <std::floating_point Real = double>
+bool import_from_file(const std::filesystem::path &path) {
+    std::lock_guard lock{detail::planner_mutex()};
+    return detail::fftw_types<Real>::import_wisdom_from_filename(path.string().c_str()) != 0;
+}
+
+/// Merges wisdom from a string. Returns false if the string is not valid wisdom.
+template <std::floating_point Real = double> bool import_from_string(const std::string &wisdom) {
+    std::lock_guard lock{detail::planner_mutex()};
+    return detail::fftw_types<Real>::import_wisdom_from_string(wisdom.c_str()) != 0;
+}
+
+/// Merges the system-wide wisdom (usually /etc/fftw/wisdom). Returns false if there is none.
+template <std::floating_point Real = double> bool import_system() {
+    std::lock_guard lock{detail::planner_mutex()};
+    return detail::fftw_types<Real>::import_system_wisdom() != 0;
+}
+
+/// Returns all wisdom accumulated so far.
+template <std::floating_point Real = double> std::string export_to_string() {
+    using types = detail::fftw_types<Real>;
+    std::lock_guard lock{detail::planner_mutex()};
+    std::unique_ptr<char, detail::fftw_free_t> str{types::export_wisdom_to_string(), types::free};
+    if (!str) { throw std::runtime_error("failed to export wisdom"); }
+    return std::string{str.get()};
+}
+
+/// Writes all wisdom accumulated so far to a file.
+/// The file is replaced atomically, so a crash during export never leaves truncated wisdom behind.
+template <std::floating_point Real = double>
+void export_to_file(const std::filesystem::path &path) {
+    auto tmp = path;
+    tmp += ".tmp";
+    {
+        std::lock_guard lock{detail::planner_mutex()};
+        if (detail::fftw_types<Real>::export_wisdom_to_filename(tmp.string().c_str()) == 0) {
+            throw std::runtime_error("failed to export wisdom to " + tmp.string());
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        throw std::runtime_error("failed to export wisdom to " + path.string());
+    }
+}
+
+/// Drops all accumulated wisdom.
+template <std::floating_point Real = double> void forget() {
+    std::lock_guard lock{detail::planner_mutex()};
+    detail::fftw_types<Real>::forget_wisdom();
+}
+
+} // namespace wisdom
+
+/// RAII owner of a wisdom file for one precision.
+/// On construction, wisdom is merged from the file; if that fails (e.g. on the first run),
+/// the system wisdom is used instead, if requested. On destruction, all wisdom accumulated by the
+/// process (including anything planned with MEASURE or PATIENT in the meantime) is written back.
+///
+/// \code
+/// int main() {
+///     fftw::wisdom_file wisdom{"app.wisdom"};
+///     fftw::warm_up(shapes, fftw::PATIENT);
+///     ...
+/// }
+/// \endcode
+template <std::floating_point Real> class basic_wisdom_file {
+  public:
+    struct options {
+        bool system_fallback{true}; ///< import system wisdom if the file can't be loaded
+        bool export_on_exit{true};  ///< export all wisdom to the file on destruction
+    };
+
+    explicit basic_wisdom_file(std::filesystem::path path)
+        : basic_wisdom_file(std::move(path), options{}) {}
+
+    basic_wisdom_file(std::filesystem::path path, options opts)
+        : path(std::move(path)), opts(opts) {
+        loaded = wisdom::import_from_file<Real>(this->path);
+        if (!loaded && opts.system_fallback) { system_loaded = wisdom::import_system<Real>(); }
+    }
+
+    basic_wisdom_file(const basic_wisdom_file &) = delete;
+    basic_wisdom_file &operator=(const basic_wisdom_file &) = delete;
+
+    ~basic_wisdom_file() {
+        if (!opts.export_on_exit) { return; }
+        try {
+            save();
+        } catch (const std::exception &) {
+            // never throw from a destructor; losing wisdom only costs planning time
+        }
+    }
+
+    /// Exports all accumulated wisdom to the file now.
+    void save() const { wisdom::export_to_file<Real>(path); }
+
+    /// Merges additional wisdom, e.g. received from another process.
+    bool merge(const std::string &other) const { return wisdom::import_from_string<Real>(other); }
+
+    /// Whether wisdom was loaded from the file.
+    [[nodiscard]] bool loaded_from_file() const { return loaded; }
+
+    /// Whether the system wisdom was loaded as a fallback.
+    [[nodiscard]] bool loaded_from_system() const { return system_loaded; }
+
+    [[nodiscard]] const std::filesystem::path &file() const { return path; }
+
+  private:
+    std::filesystem::path path;
+    options opts;
+    bool loaded{false};
+    bool system_loaded{false};
+};
+
+using wisdom_file = basic_wisdom_file<double>;
+
+/// The kind of transform a plan_shape describes.
+enum class transform_kind {
+    C2C,
+    R2C,
+    C2R,
+};
+
+/// A transform to plan ahead of time with warm_up().
+/// Extents are given in row-major order, as in the dft factories for layout_right.
+struct plan_shape {
+    transform_kind kind{transform_kind::C2C};
+    std::vector<int> extents;
+    Direction direction{FORWARD}; ///< ignored for R2C and C2R
+    bool in_place{false};
+};
+
+namespace detail {
+
+inline auto plan_shape_sizes(const plan_shape &shape) -> std::pair<size_t, size_t> {
+    if (shape.extents.empty()) { throw std::invalid_argument("plan_shape without extents"); }
+
+    size_t real = 1, complex = 1;
+    for (size_t i = 0; i < shape.extents.size(); ++i) {
+        auto n = shape.extents[i];
+        if (n <= 0) { throw std::invalid_argument("non-positive extent in plan_shape"); }
+        real *= n;
+        complex *= (i + 1 == shape.extents.size() && shape.kind != transform_kind::C2C)
+                       ? size_t(n / 2 + 1)
+                       : size_t(n);
+    }
+    return {real, complex};
+}
+
+} // namespace detail
+
+/// Plans every shape once on scratch buffers and discards the plans.
+/// This fills the process wisdom, so that later planning of the same shapes with the same flags
+/// (through the dft factories or plan_cache) is nearly free. Combined with wisdom_file, the
+/// expensive planning happens once per machine instead of once per process and shape.
+/// Wisdom depends on the thread count, so pass the same `threads` the real plans will use.
+template <std::floating_point Real = double>
+void warm_up(std::span<const plan_shape> shapes, Flags flags, int threads = 1) {
+    using types = detail::fftw_types<Real>;
+    using complex = typename types::complex;
+
+    for (const auto &shape : shapes) {
+        auto [real_size, complex_size] = detail::plan_shape_sizes(shape);
+        auto rank = int(shape.extents.size());
+        auto *n = shape.extents.data();
+
+        // fftw_malloc keeps the scratch buffers in the same alignment class as basic_buffer.
+        using scratch_ptr = std::unique_ptr<void, detail::fftw_free_t>;
+        auto complex_bytes = complex_size * sizeof(complex);
+        auto other_bytes =
+            shape.kind == transform_kind::C2C ? complex_bytes : real_size * sizeof(Real);
+
+        // in-place real transforms use the padded layout, which fits in the complex buffer
+        scratch_ptr c{types::malloc(complex_bytes), types::free};
+        scratch_ptr r{shape.in_place ? nullptr : types::malloc(other_bytes), types::free};
+        auto *c_data = reinterpret_cast<complex *>(c.get());
+        auto *other = shape.in_place ? c.get() : r.get();
+        if (!c || !other) { throw std::bad_alloc(); }
+
+        typename types::plan p = nullptr;
+        {
+            std::lock_guard lock{detail::planner_mutex()};
+            detail::plan_with_threads<Real>(threads);
+            switch (shape.kind) {
+            case transform_kind::C2C:
+                p = types::plan_dft(rank, n, c_data, reinterpret_cast<complex *>(other),
+                                    shape.direction, flags);
+                break;
+            case transform_kind::R2C:
+                p = types::plan_dft_r2c(rank, n, reinterpret_cast<Real *>(other), c_data, flags);
+                break;
+            case transform_kind::C2R:
+                p = types::plan_dft_c2r(rank, n, c_data, reinterpret_cast<Real *>(other), flags);
+                break;
+            }
+        }
+        if (p == nullptr) { throw std::runtime_error("failed to plan warm-up shape"); }
+        detail::destroy_plan<Real>(p);
+    }
+}
+
+template <std::floating_point Real = double>
+void warm_up(std::initializer_list<plan_shape> shapes, Flags flags, int threads = 1) {
+    warm_up<Real>(std::span<const plan_shape>{shapes.begin(), shapes.size()}, flags, threads);
+}
+
+} // namespace fftw
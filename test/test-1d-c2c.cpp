@@ -28,4 +28,53 @@ TEST(Basic1dWrapper, TwoWay) {
     }
 
     EXPECT_THAT(out2, ElementsAreComplexNear(in));
-}
\ No newline at end of file
+}
+
+TEST(Basic1dWrapper, MultiThreaded) {
+    int N = 1024;
+
+    fftw::buffer in(N), out(N), out2(N);
+
+    // without FFTW threads the thread count is ignored, so this passes in both configurations
+    auto p = fftw::plan<>::dft(in, out, fftw::FORWARD, fftw::Flags::ESTIMATE, 4);
+    auto pInv = fftw::plan<>::dft(out, out2, fftw::BACKWARD, fftw::Flags::ESTIMATE, 4);
+
+    for (int j = 0; j < N; ++j) {
+        in[j] = {std::cos(2.0 * std::numbers::pi * j / N),
+                 std::sin(2.0 * std::numbers::pi * 3 * j / N)};
+    }
+
+    p();
+    pInv();
+
+    for (auto &elem : out2) {
+        elem /= double(N);
+    }
+
+    EXPECT_THAT(out2, ElementsAreComplexNear(in));
+    EXPECT_THROW(fftw::plan<>::dft(in, out, fftw::FORWARD, fftw::Flags::ESTIMATE, 0),
+                 std::invalid_argument);
+}
+
+TEST(Basic1dWrapper, MultiThreadedAfterThreadsGuard) {
+    int N = 256;
+
+    fftw::buffer in(N), out(N), expected(N);
+    for (int j = 0; j < N; ++j) {
+        in[j] = {std::cos(2.0 * std::numbers::pi * j / N), double(j % 7)};
+    }
+    fftw::plan<>::dft(in, expected, fftw::FORWARD, fftw::Flags::ESTIMATE)();
+
+    // the threads library is initialized again after a guard released it, also by a second guard
+    for (int k = 0; k < 2; ++k) {
+        {
+            fftw::threads_guard guard;
+            auto p = fftw::plan<>::dft(in, out, fftw::FORWARD, fftw::Flags::ESTIMATE, 4);
+            p();
+            EXPECT_THAT(out, ElementsAreComplexNear(expected));
+        }
+        auto p = fftw::plan<>::dft(in, out, fftw::FORWARD, fftw::Flags::ESTIMATE, 4);
+        p();
+        EXPECT_THAT(out, ElementsAreComplexNear(expected));
+    }
+}
@@ -0,0 +1,113 @@
+#include "fftw-cpp/fftw-cpp.h"
+#include "util.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace {
+std::complex<double> sample(std::size_t x, std::size_t y, std::size_t t) {
+    return {std::cos(double(x * 7 + y * 3 + t) / 5.0), std::sin(double(x + y * t) / 3.0)};
+}
+
+template <class Cube> void fill(Cube &cube) {
+    for (std::size_t x = 0; x < cube.extent(0); ++x) {
+        for (std::size_t y = 0; y < cube.extent(1); ++y) {
+            for (std::size_t t = 0; t < cube.extent(2); ++t) {
+                cube(x, y, t) = sample(x, y, t);
+            }
+        }
+    }
+}
+} // namespace
+
+TEST(AxesPlan, LastAxisMatchesLoopOf1dPlans) {
+    std::size_t X = 3, Y = 4, T = 8;
+    fftw::mdbuffer<3u> in{X, Y, T}, out{X, Y, T};
+    fftw::buffer line_in(T), line_out(T);
+    fill(in);
+
+    auto p = fftw::plan<3u>::dft_axes(in.to_mdspan(), out.to_mdspan(), {2}, fftw::FORWARD,
+                                      fftw::ESTIMATE);
+    auto pLine = fftw::plan<1u>::dft(line_in, line_out, fftw::FORWARD, fftw::ESTIMATE);
+    p();
+
+    for (std::size_t x = 0; x < X; ++x) {
+        for (std::size_t y = 0; y < Y; ++y) {
+            for (std::size_t t = 0; t < T; ++t) {
+                line_in[t] = in(x, y, t);
+            }
+            pLine();
+            for (std::size_t t = 0; t < T; ++t) {
+                EXPECT_THAT(out(x, y, t), IsComplexNear(line_out[t]));
+            }
+        }
+    }
+}
+
+TEST(AxesPlan, FirstAxisOfLayoutLeft) {
+    std::size_t X = 6, Y = 2, T = 3;
+    fftw::mdbuffer<3u, fftw::layout_left> in{X, Y, T}, out{X, Y, T};
+    fftw::buffer line_in(X), line_out(X);
+    fill(in);
+
+    auto p = fftw::plan<3u>::dft_axes(in.to_mdspan(), out.to_mdspan(), {0}, fftw::FORWARD,
+                                      fftw::ESTIMATE);
+    auto pLine = fftw::plan<1u>::dft(line_in, line_out, fftw::FORWARD, fftw::ESTIMATE);
+    p();
+
+    for (std::size_t y = 0; y < Y; ++y) {
+        for (std::size_t t = 0; t < T; ++t) {
+            for (std::size_t x = 0; x < X; ++x) {
+                line_in[x] = in(x, y, t);
+            }
+            pLine();
+            for (std::size_t x = 0; x < X; ++x) {
+                EXPECT_THAT(out(x, y, t), IsComplexNear(line_out[x]));
+            }
+        }
+    }
+}
+
+TEST(AxesPlan, AllAxesMatchFullTransform) {
+    std::size_t X = 3, Y = 4, T = 5;
+    fftw::mdbuffer<3u> in{X, Y, T}, out{X, Y, T}, expected{X, Y, T};
+    fill(in);
+
+    fftw::plan<3u>::dft(in.to_mdspan(), expected.to_mdspan(), fftw::FORWARD, fftw::ESTIMATE)();
+    fftw::plan<3u>::dft_axes(in.to_mdspan(), out.to_mdspan(), {2, 0, 1}, fftw::FORWARD,
+                             fftw::ESTIMATE)();
+
+    std::span out_span{out.data(), out.size()};
+    std::span expected_span{expected.data(), expected.size()};
+    EXPECT_THAT(out_span, ElementsAreComplexNear(expected_span));
+}
+
+TEST(AxesPlan, TwoAxesInPlaceThenInverse) {
+    std::size_t X = 4, Y = 3, T = 6;
+    fftw::mdbuffer<3u> data{X, Y, T};
+    fill(data);
+    auto view = data.to_mdspan();
+
+    fftw::plan<3u>::dft_axes(view, view, {0, 2}, fftw::FORWARD, fftw::ESTIMATE)();
+    fftw::plan<3u>::dft_axes(view, view, {0, 2}, fftw::BACKWARD, fftw::ESTIMATE)();
+
+    for (std::size_t x = 0; x < X; ++x) {
+        for (std::size_t y = 0; y < Y; ++y) {
+            for (std::size_t t = 0; t < T; ++t) {
+                EXPECT_THAT(data(x, y, t) / double(X * T), IsComplexNear(sample(x, y, t)));
+            }
+        }
+    }
+}
+
+TEST(AxesPlan, ValidatesAxes) {
+    fftw::mdbuffer<3u> a{2, 3, 4}, b{2, 4, 3};
+    auto Plan = [&](auto in, auto out, std::vector<std::size_t> axes) {
+        return fftw::plan<3u>::dft_axes(in, out, axes, fftw::FORWARD, fftw::ESTIMATE);
+    };
+
+    EXPECT_THROW(Plan(a.to_mdspan(), a.to_mdspan(), {}), std::invalid_argument);
+    EXPECT_THROW(Plan(a.to_mdspan(), a.to_mdspan(), {3}), std::invalid_argument);
+    EXPECT_THROW(Plan(a.to_mdspan(), a.to_mdspan(), {1, 1}), std::invalid_argument);
+    EXPECT_THROW(Plan(a.to_mdspan(), b.to_mdspan(), {0}), std::invalid_argument);
+}
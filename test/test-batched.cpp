@@ -0,0 +1,200 @@
+#include "fftw-cpp/fftw-cpp.h"
+#include "util.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <numbers>
+#include <span>
+
+namespace {
+std::complex<double> sample(std::size_t batch, std::size_t j) {
+    return {std::cos(2.0 * std::numbers::pi * double((batch + 1) * j) / 7.0),
+            std::sin(double(batch) + double(j) / 3.0)};
+}
+} // namespace
+
+TEST(BatchedPlan, MatchesLoopOfPlans) {
+    std::size_t howmany = 5, N = 8;
+    fftw::mdbuffer<2u> in{howmany, N}, out{howmany, N};
+    fftw::buffer row_in(N), row_out(N);
+
+    auto p = fftw::batched_plan<1u>::dft(in.to_mdspan(), out.to_mdspan(), fftw::FORWARD,
+                                         fftw::ESTIMATE);
+    auto pRow = fftw::plan<1u>::dft(row_in, row_out, fftw::FORWARD, fftw::ESTIMATE);
+
+    for (std::size_t b = 0; b < howmany; ++b) {
+        for (std::size_t j = 0; j < N; ++j) {
+            in(b, j) = sample(b, j);
+        }
+    }
+    p();
+
+    for (std::size_t b = 0; b < howmany; ++b) {
+        for (std::size_t j = 0; j < N; ++j) {
+            row_in[j] = in(b, j);
+        }
+        pRow();
+        std::span batch_out{&out(b, 0), N};
+        EXPECT_THAT(batch_out, ElementsAreComplexNear(row_out)) << "in batch " << b;
+    }
+}
+
+TEST(BatchedPlan, LayoutLeftBatchesAlongLastIndex) {
+    std::size_t howmany = 3, N = 6;
+    fftw::mdbuffer<2u, fftw::layout_left> in{N, howmany}, out{N, howmany}, out2{N, howmany};
+
+    auto p = fftw::batched_plan<1u>::dft(in.to_mdspan(), out.to_mdspan(), fftw::FORWARD,
+                                         fftw::ESTIMATE);
+    auto pInv = fftw::batched_plan<1u>::dft(out.to_mdspan(), out2.to_mdspan(), fftw::BACKWARD,
+                                            fftw::ESTIMATE);
+
+    for (std::size_t b = 0; b < howmany; ++b) {
+        for (std::size_t j = 0; j < N; ++j) {
+            in(j, b) = sample(b, j);
+        }
+    }
+    p();
+    pInv();
+
+    for (std::size_t b = 0; b < howmany; ++b) {
+        // DC component of each batch is the sum of that column only
+        std::complex<double> sum{};
+        for (std::size_t j = 0; j < N; ++j) {
+            sum += in(j, b);
+            EXPECT_THAT(out2(j, b) / double(N), IsComplexNear(in(j, b)));
+        }
+        EXPECT_THAT(out(0, b), IsComplexNear(sum));
+    }
+}
+
+TEST(BatchedPlan, ExplicitStrideAndDistance) {
+    // 4 interleaved transforms of length 8: element j of transform b lives at j * 4 + b
+    int howmany = 4, N = 8;
+    fftw::buffer in(howmany * N), out(howmany * N), row_in(N), row_out(N);
+
+    auto p = fftw::batched_plan<1u>::dft({N}, howmany, in, {.stride = howmany, .dist = 1}, out,
+                                         {.stride = howmany, .dist = 1}, fftw::FORWARD,
+                                         fftw::ESTIMATE);
+    auto pRow = fftw::plan<1u>::dft(row_in, row_out, fftw::FORWARD, fftw::ESTIMATE);
+
+    for (int b = 0; b < howmany; ++b) {
+        for (int j = 0; j < N; ++j) {
+            in[j * howmany + b] = sample(b, j);
+        }
+    }
+
+    fftw::buffer in2(howmany * N, {0.0, 0.0}), out2(howmany * N);
+    std::ranges::copy(in, in2.begin());
+    p(in2, out2); // new-array execution
+
+    for (int b = 0; b < howmany; ++b) {
+        for (int j = 0; j < N; ++j) {
+            row_in[j] = in[j * howmany + b];
+        }
+        pRow();
+        for (int j = 0; j < N; ++j) {
+            EXPECT_THAT(out2[j * howmany + b], IsComplexNear(row_out[j]));
+        }
+    }
+
+    EXPECT_THROW(fftw::batched_plan<1u>::dft({N}, howmany + 1, in, {.stride = howmany, .dist = 1},
+                                             out, {.stride = howmany, .dist = 1}, fftw::FORWARD,
+                                             fftw::ESTIMATE),
+                 std::invalid_argument);
+}
+
+TEST(BatchedPlan, TwoWay2dR2C) {
+    std::size_t howmany = 3, N = 4, M = 6;
+    fftw::rmdbuffer<3u> in{howmany, N, M}, out2{howmany, N, M};
+    fftw::mdbuffer<3u> out{howmany, N, M / 2 + 1};
+    fftw::rmdbuffer<2u> single_in{N, M};
+    fftw::mdbuffer<2u> single_out{N, M / 2 + 1};
+
+    auto p = fftw::batched_plan_r2c<2u>::dft(in.to_mdspan(), out.to_mdspan(), fftw::ESTIMATE);
+    auto pInv = fftw::batched_plan_c2r<2u>::dft(out.to_mdspan(), out2.to_mdspan(), fftw::ESTIMATE);
+    auto pSingle =
+        fftw::plan_r2c<2u>::dft(single_in.to_mdspan(), single_out.to_mdspan(), fftw::ESTIMATE);
+
+    for (std::size_t b = 0; b < howmany; ++b) {
+        for (std::size_t j = 0; j < N; ++j) {
+            for (std::size_t k = 0; k < M; ++k) {
+                in(b, j, k) = sample(b, j * M + k).real();
+            }
+        }
+    }
+    p();
+
+    for (std::size_t b = 0; b < howmany; ++b) {
+        for (std::size_t j = 0; j < N; ++j) {
+            for (std::size_t k = 0; k < M; ++k) {
+                single_in(j, k) = in(b, j, k);
+            }
+        }
+        pSingle();
+        for (std::size_t j = 0; j < N; ++j) {
+            for (std::size_t k = 0; k < M / 2 + 1; ++k) {
+                EXPECT_THAT(out(b, j, k), IsComplexNear(single_out(j, k)));
+            }
+        }
+    }
+
+    pInv();
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        EXPECT_NEAR(out2.data()[i] / double(N * M), in.data()[i], TOLERANCE);
+    }
+}
+
+TEST(BatchedPlan, ExplicitStrideR2CWithStoragePolicies) {
+    // 3 interleaved real transforms of length 10, with pooled buffers
+    int howmany = 3, N = 10, NK = N / 2 + 1;
+    fftw::pooled_rbuffer in(howmany * N), back(howmany * N);
+    fftw::pooled_buffer spectrum(howmany * NK);
+    fftw::rmdbuffer<1u> row_in{size_t(N)};
+    fftw::mdbuffer<1u> row_out{size_t(NK)};
+
+    auto p = fftw::batched_plan_r2c<1u>::dft({N}, howmany, in, {.stride = howmany, .dist = 1},
+                                             spectrum, {.stride = howmany, .dist = 1},
+                                             fftw::ESTIMATE);
+    auto pInv = fftw::batched_plan_c2r<1u>::dft({N}, howmany, spectrum,
+                                                {.stride = howmany, .dist = 1}, back,
+                                                {.stride = howmany, .dist = 1}, fftw::ESTIMATE);
+    auto pRow = fftw::plan_r2c<1u>::dft(row_in.to_mdspan(), row_out.to_mdspan(), fftw::ESTIMATE);
+
+    for (int b = 0; b < howmany; ++b) {
+        for (int j = 0; j < N; ++j) {
+            in[j * howmany + b] = sample(b, j).real();
+        }
+    }
+    p();
+
+    for (int b = 0; b < howmany; ++b) {
+        for (int j = 0; j < N; ++j) {
+            row_in(j) = in[j * howmany + b];
+        }
+        pRow();
+        for (int k = 0; k < NK; ++k) {
+            EXPECT_THAT(spectrum[k * howmany + b], IsComplexNear(row_out(k)));
+        }
+    }
+
+    pInv();
+    for (int i = 0; i < howmany * N; ++i) {
+        EXPECT_NEAR(back[i] / double(N), in[i], TOLERANCE);
+    }
+}
+
+TEST(BatchedPlan, ValidatesExtents) {
+    fftw::mdbuffer<2u> a{4, 8}, b{5, 8}, c{4, 6};
+    fftw::rmdbuffer<2u> r{4, 8};
+    fftw::mdbuffer<2u> half{4, 4};
+
+    EXPECT_THROW(fftw::batched_plan<1u>::dft(a.to_mdspan(), b.to_mdspan(), fftw::FORWARD,
+                                             fftw::ESTIMATE),
+                 std::invalid_argument);
+    EXPECT_THROW(fftw::batched_plan<1u>::dft(a.to_mdspan(), c.to_mdspan(), fftw::FORWARD,
+                                             fftw::ESTIMATE),
+                 std::invalid_argument);
+    EXPECT_THROW(fftw::batched_plan_r2c<1u>::dft(r.to_mdspan(), half.to_mdspan(), fftw::ESTIMATE),
+                 std::invalid_argument);
+}
@@ -0,0 +1,114 @@
+#include "fftw-cpp/fftw-cpp.h"
+#include "util.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace {
+auto &pool() { return fftw::buffer_pool<double>::global(); }
+} // namespace
+
+TEST(BufferPool, ReusesFreedBlocks) {
+    pool().trim();
+    auto before = pool().stats();
+
+    const void *first = nullptr;
+    {
+        fftw::pooled_buffer a(1000);
+        first = a.data();
+    }
+    EXPECT_GT(pool().stats().cached_bytes, before.cached_bytes);
+
+    // 900 elements fall in the same power-of-two size class as 1000
+    fftw::pooled_buffer b(900);
+    EXPECT_EQ(b.data(), first);
+
+    auto after = pool().stats();
+    EXPECT_EQ(after.misses, before.misses + 1);
+    EXPECT_EQ(after.hits, before.hits + 1);
+}
+
+TEST(BufferPool, KeepsFftwAlignment) {
+    fftw::buffer reference(64);
+    for (std::size_t n : {1u, 7u, 64u, 1000u, 4099u}) {
+        fftw::pooled_buffer buf(n);
+        fftw::pooled_rbuffer rbuf(n);
+        EXPECT_EQ(fftw_alignment_of(reinterpret_cast<double *>(buf.data())),
+                  fftw_alignment_of(reinterpret_cast<double *>(reference.data())));
+        EXPECT_EQ(fftw_alignment_of(rbuf.data()),
+                  fftw_alignment_of(reinterpret_cast<double *>(reference.data())));
+    }
+}
+
+TEST(BufferPool, PlansOnPooledBuffers) {
+    std::size_t N = 16;
+    fftw::pooled_buffer in(N), out(N), out2(N);
+    fftw::pooled_mdbuffer<2u> in2d{4, 4}, out2d{4, 4};
+    fftw::buffer ref_in(N), ref_out(N);
+
+    for (std::size_t i = 0; i < N; ++i) {
+        in[i] = ref_in[i] = in2d.data()[i] = {std::cos(double(i)), std::sin(double(i) / 2.0)};
+    }
+
+    fftw::plan<1u>::dft(ref_in, ref_out, fftw::FORWARD, fftw::ESTIMATE)();
+    auto p = fftw::plan<1u>::dft(in, out, fftw::FORWARD, fftw::ESTIMATE);
+    p();
+    EXPECT_THAT(out, ElementsAreComplexNear(ref_out));
+
+    fftw::plan<2u>::dft(in2d, out2d, fftw::FORWARD, fftw::ESTIMATE)();
+    fftw::plan<2u>::dft(in2d.to_mdspan(), out2d.to_mdspan(), fftw::BACKWARD, fftw::ESTIMATE)(
+        out2d.to_mdspan(), in2d.to_mdspan());
+    for (std::size_t i = 0; i < N; ++i) {
+        EXPECT_THAT(in2d.data()[i] / double(N), IsComplexNear(ref_in[i]));
+    }
+}
+
+TEST(BufferPool, TrimAndCapacity) {
+    auto old_capacity = pool().capacity();
+    pool().set_capacity(0);
+    {
+        // more blocks of one class than a thread cache holds
+        std::vector<fftw::pooled_buffer> buffers;
+        for (std::size_t i = 0; i < 2 * fftw::buffer_pool<double>::thread_cache_blocks; ++i) {
+            buffers.emplace_back(256);
+        }
+    }
+    EXPECT_EQ(pool().stats().shared_bytes, 0u);
+
+    pool().set_capacity(old_capacity);
+    pool().trim();
+    EXPECT_EQ(pool().stats().cached_bytes, 0u);
+}
+
+TEST(BufferPool, ConcurrentUse) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < 200; ++i) {
+                fftw::pooled_buffer buf(std::size_t(64 + 37 * ((i + t) % 9)), {double(t), 0.0});
+                for (auto &x : buf) {
+                    ASSERT_EQ(x, std::complex<double>(double(t), 0.0));
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    // blocks of exited threads went back to the shared list (or fftw_free)
+    pool().trim();
+    EXPECT_EQ(pool().stats().cached_bytes, 0u);
+}
+
+TEST(BufferPool, OversizedBypassesPool) {
+    auto before = pool().stats();
+    {
+        fftw::pooled_rbuffer huge(fftw::buffer_pool<double>::max_block / sizeof(double) + 1);
+    }
+    auto after = pool().stats();
+    EXPECT_EQ(after.oversized, before.oversized + 1);
+    EXPECT_EQ(after.cached_bytes, before.cached_bytes);
+}
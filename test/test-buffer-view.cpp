@@ -0,0 +1,116 @@
+#include "fftw-cpp/fftw-cpp.h"
+#include "util.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <numbers>
+#include <span>
+#include <vector>
+
+namespace {
+
+std::vector<std::complex<double>> signal(size_t n) {
+    std::vector<std::complex<double>> x(n);
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = {std::cos(2.0 * std::numbers::pi * double(i) / double(n)), double(i % 3)};
+    }
+    return x;
+}
+
+} // namespace
+
+TEST(BufferView, WrapsVectorAndSpan) {
+    std::vector<std::complex<double>> vec(8);
+    fftw::buffer_view from_vector{vec};
+    EXPECT_EQ(from_vector.data(), vec.data());
+    EXPECT_EQ(from_vector.size(), vec.size());
+
+    std::span<std::complex<double>> span{vec};
+    fftw::buffer_view from_span{span};
+    from_span[3] = {1.0, 2.0};
+    EXPECT_EQ(vec[3], std::complex<double>(1.0, 2.0));
+
+    fftw::buffer owned(8);
+    fftw::buffer_view from_buffer{owned};
+    EXPECT_EQ(from_buffer.data(), owned.data());
+    EXPECT_TRUE(from_buffer.is_simd_aligned());
+}
+
+TEST(BufferView, ReportsAlignment) {
+    fftw::rbuffer owned(16);
+    fftw::rbuffer_view aligned{owned.data(), 8};
+    fftw::rbuffer_view shifted{owned.data() + 1, 8};
+
+    EXPECT_EQ(aligned.alignment(), 0);
+    EXPECT_NE(shifted.alignment(), 0);
+    EXPECT_FALSE(shifted.is_simd_aligned());
+}
+
+TEST(BufferView, MatchesOwnedBuffer) {
+    const size_t N = 16;
+    auto x = signal(N);
+
+    fftw::buffer in(N), out(N);
+    std::copy(x.begin(), x.end(), in.begin());
+    auto p = fftw::plan<1u>::dft(in, out, fftw::FORWARD, fftw::ESTIMATE);
+    p();
+
+    std::vector<std::complex<double>> vec_in = x, vec_out(N);
+    fftw::buffer_view view_in{vec_in}, view_out{vec_out};
+    auto p_view = fftw::plan<1u>::dft(view_in, view_out, fftw::FORWARD, fftw::ESTIMATE);
+    p_view();
+
+    EXPECT_THAT(vec_out, ElementsAreComplexNear(out));
+}
+
+TEST(BufferView, FallsBackToUnalignedPlan) {
+    namespace stdex = std::experimental;
+    using d1 = stdex::dextents<std::size_t, 1u>;
+    const size_t N = 16, NK = N / 2 + 1;
+
+    fftw::rbuffer in(N);
+    fftw::buffer out(NK);
+    auto p = fftw::plan_r2c<1u>::dft(stdex::mdspan<double, d1>{in.data(), N},
+                                     stdex::mdspan<std::complex<double>, d1>{out.data(), NK},
+                                     fftw::ESTIMATE);
+
+    // One element past an aligned allocation is in another alignment class.
+    std::vector<double> storage(N + 1);
+    for (size_t i = 0; i < N; ++i) {
+        storage[i + 1] = in[i] = std::sin(2.0 * std::numbers::pi * double(3 * i) / double(N));
+    }
+    double *shifted = storage.data() + 1;
+    fftw::buffer expected(NK), actual(NK);
+
+    EXPECT_TRUE(p.is_aligned_for(in.data(), expected.data()));
+    EXPECT_EQ(p.is_aligned_for(shifted, actual.data()),
+              fftw::rbuffer_view(shifted, N).is_simd_aligned());
+
+    p(stdex::mdspan<double, d1>{in.data(), N},
+      stdex::mdspan<std::complex<double>, d1>{expected.data(), NK});
+    p(stdex::mdspan<double, d1>{shifted, N},
+      stdex::mdspan<std::complex<double>, d1>{actual.data(), NK});
+
+    EXPECT_THAT(actual, ElementsAreComplexNear(expected));
+}
+
+TEST(BufferView, UnalignedPlanSkipsFallback) {
+    const size_t N = 16;
+    fftw::rbuffer owned(N + 1);
+    fftw::rbuffer_view in{owned.data(), N}, shifted_in{owned.data() + 1, N};
+    fftw::rbuffer out(N), out2(N);
+
+    auto p = fftw::plan_r2r<1u>::dft(in, out, fftw::R2RKind::REDFT10,
+                                     fftw::ESTIMATE | fftw::UNALIGNED);
+    EXPECT_TRUE(p.is_aligned_for(shifted_in.data(), out2.data()));
+
+    for (size_t i = 0; i <= N; ++i) { owned[i] = double(i * i); }
+    p(shifted_in, out2);
+
+    fftw::rbuffer aligned_in(N), expected(N);
+    std::copy(shifted_in.begin(), shifted_in.end(), aligned_in.begin());
+    auto p_aligned =
+        fftw::plan_r2r<1u>::dft(aligned_in, expected, fftw::R2RKind::REDFT10, fftw::ESTIMATE);
+    p_aligned();
+    for (size_t i = 0; i < N; ++i) { EXPECT_NEAR(out2[i], expected[i], TOLERANCE) << i; }
+}
@@ -0,0 +1,119 @@
+#include "fftw-cpp/fftw-cpp.h"
+#include "util.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <numbers>
+#include <stdexcept>
+#include <vector>
+
+using fftw::convolution_method;
+
+namespace {
+
+std::vector<double> make_signal(size_t length, double frequency) {
+    std::vector<double> x(length);
+    for (size_t i = 0; i < length; ++i) {
+        x[i] = std::sin(2.0 * std::numbers::pi * frequency * double(i)) + 0.1 * double(i % 5);
+    }
+    return x;
+}
+
+/// Direct-form FIR filter, delayed by `latency` samples like the convolver output.
+std::vector<double> naive_filter(const std::vector<double> &x, const std::vector<double> &h,
+                                 size_t latency) {
+    std::vector<double> y(x.size(), 0.0);
+    for (size_t i = latency; i < x.size(); ++i) {
+        for (size_t k = 0; k < h.size() && k <= i - latency; ++k) {
+            y[i] += h[k] * x[i - latency - k];
+        }
+    }
+    return y;
+}
+
+void expect_near(const std::vector<double> &actual, const std::vector<double> &expected) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        EXPECT_NEAR(actual[i], expected[i], TOLERANCE) << i;
+    }
+}
+
+} // namespace
+
+class Convolver : public ::testing::TestWithParam<convolution_method> {};
+
+TEST_P(Convolver, MatchesDirectFilterForAnyChunking) {
+    auto kernel = make_signal(37, 0.07);
+    auto input = make_signal(1000, 0.013);
+
+    fftw::convolver fir{kernel, GetParam(), fftw::ESTIMATE};
+    EXPECT_GE(fir.fft_size(), kernel.size());
+    EXPECT_EQ(fir.block_size(), fir.fft_size() - kernel.size() + 1);
+
+    std::vector<double> output(input.size());
+    const size_t chunks[] = {1, 7, 64, 3, 250, 1, 500};
+    size_t pos = 0;
+    for (size_t i = 0; pos < input.size(); ++i) {
+        auto count = std::min(chunks[i % std::size(chunks)], input.size() - pos);
+        fir.push(std::span{input}.subspan(pos, count), std::span{output}.subspan(pos, count));
+        pos += count;
+    }
+
+    expect_near(output, naive_filter(input, kernel, fir.latency()));
+}
+
+TEST_P(Convolver, KernelLongerThanBlock) {
+    // A small FFT size makes the overlap span several blocks.
+    auto kernel = make_signal(20, 0.11);
+    auto input = make_signal(300, 0.021);
+
+    fftw::convolver fir{kernel, GetParam(), fftw::ESTIMATE, 24};
+    EXPECT_EQ(fir.block_size(), 5u);
+
+    std::vector<double> output(input.size());
+    fir.push(input, output);
+    expect_near(output, naive_filter(input, kernel, fir.latency()));
+}
+
+TEST_P(Convolver, ResetRestartsTheStream) {
+    auto kernel = make_signal(9, 0.2);
+    auto input = make_signal(200, 0.05);
+
+    fftw::convolver fir{kernel, GetParam(), fftw::ESTIMATE};
+    std::vector<double> first(input.size()), second(input.size());
+    fir.push(input, first);
+    fir.reset();
+    fir.push(input, second);
+
+    expect_near(second, first);
+}
+
+INSTANTIATE_TEST_SUITE_P(Methods, Convolver,
+                         ::testing::Values(convolution_method::OVERLAP_SAVE,
+                                           convolution_method::OVERLAP_ADD));
+
+TEST(ConvolverSize, OptimalFftSize) {
+    for (size_t m : {1u, 2u, 17u, 100u, 1000u, 4097u}) {
+        auto n = fftw::convolver::optimal_fft_size(m);
+        EXPECT_GE(n, m);
+        // blocks much shorter than the kernel waste most of each transform
+        EXPECT_GE(n - m + 1, m / 2) << m;
+
+        auto rest = n;
+        for (size_t p : {2u, 3u, 5u, 7u}) {
+            while (rest % p == 0) { rest /= p; }
+        }
+        EXPECT_EQ(rest, 1u) << n;
+    }
+}
+
+TEST(ConvolverSize, Validates) {
+    std::vector<double> kernel(16, 1.0), empty;
+    EXPECT_THROW(fftw::convolver{empty}, std::invalid_argument);
+    EXPECT_THROW(fftw::convolver(kernel, convolution_method::OVERLAP_SAVE, fftw::ESTIMATE, 8),
+                 std::invalid_argument);
+
+    fftw::convolver fir{kernel, convolution_method::OVERLAP_SAVE, fftw::ESTIMATE};
+    std::vector<double> in(10), out(9);
+    EXPECT_THROW(fir.push(in, out), std::invalid_argument);
+}
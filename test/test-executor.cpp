@@ -0,0 +1,143 @@
+#include "fftw-cpp/fftw-cpp.h"
+#include "util.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <coroutine>
+#include <future>
+#include <numbers>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+void fill(fftw::buffer &buf, double frequency) {
+    for (size_t i = 0; i < buf.size(); ++i) {
+        buf[i] = std::polar(1.0, 2.0 * std::numbers::pi * frequency * double(i));
+    }
+}
+
+/// Blocks the worker that runs it until released, so that later jobs stay queued.
+struct gate {
+    std::promise<void> opened;
+    std::shared_future<void> future{opened.get_future().share()};
+    mutable std::promise<void> entered;
+
+    void operator()() const {
+        entered.set_value();
+        future.wait();
+    }
+    void wait_entered() { entered.get_future().wait(); }
+    void release() { opened.set_value(); }
+};
+
+/// The smallest coroutine type that runs eagerly and reports completion.
+struct eager_task {
+    struct promise_type {
+        eager_task get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+eager_task await_job(fftw::job j, std::promise<bool> &result) {
+    try {
+        co_await j;
+        result.set_value(true);
+    } catch (const fftw::job_cancelled &) {
+        result.set_value(false);
+    }
+}
+
+} // namespace
+
+TEST(Executor, MatchesSynchronousExecution) {
+    const size_t N = 64;
+    fftw::buffer in(N), out(N), expected(N);
+    fill(in, 3.0 / double(N));
+
+    auto p = fftw::plan<1u>::dft(in, expected, fftw::FORWARD, fftw::ESTIMATE);
+    p();
+
+    fftw::executor pool{2};
+    EXPECT_EQ(pool.size(), 2u);
+    auto j = pool.submit(p, in, out);
+    j.get();
+    EXPECT_TRUE(j.done());
+    EXPECT_THAT(out, ElementsAreComplexNear(expected));
+}
+
+TEST(Executor, BatchSubmission) {
+    const size_t N = 32, jobs = 16;
+    std::vector<fftw::buffer> ins, outs;
+    for (size_t b = 0; b < jobs; ++b) {
+        ins.emplace_back(N);
+        outs.emplace_back(N);
+        fill(ins.back(), double(b) / double(N));
+    }
+    auto p = fftw::plan<1u>::dft(ins[0], outs[0], fftw::FORWARD, fftw::ESTIMATE);
+
+    fftw::executor pool{4};
+    auto handles = pool.submit_batch(p, ins, outs);
+    ASSERT_EQ(handles.size(), jobs);
+    fftw::executor::wait_all(handles);
+
+    // a pure tone lands in a single bin
+    for (size_t b = 0; b < jobs; ++b) {
+        EXPECT_NEAR(std::abs(outs[b][b]), double(N), 1e-9) << b;
+        EXPECT_NEAR(std::abs(outs[b][(b + 1) % N]), 0.0, 1e-9) << b;
+    }
+}
+
+TEST(Executor, CancelsQueuedJobs) {
+    fftw::executor pool{1};
+    gate blocker;
+    std::atomic<int> runs{0};
+    auto count = [&runs] { ++runs; };
+
+    auto first = pool.submit(blocker);
+    blocker.wait_entered();
+    auto second = pool.submit(count);
+    auto third = pool.submit(count);
+    auto fourth = pool.submit(count);
+
+    EXPECT_TRUE(second.cancel());
+    EXPECT_FALSE(second.cancel());
+    EXPECT_EQ(pool.cancel_all(), 2u);
+    blocker.release();
+    first.get();
+
+    EXPECT_THROW(second.get(), fftw::job_cancelled);
+    EXPECT_THROW(third.get(), fftw::job_cancelled);
+    EXPECT_THROW(fourth.get(), fftw::job_cancelled);
+    EXPECT_FALSE(first.cancel());
+    EXPECT_EQ(runs.load(), 0);
+}
+
+TEST(Executor, PropagatesExceptions) {
+    fftw::executor pool{1};
+    auto fail = [] { throw std::runtime_error("boom"); };
+    auto j = pool.submit(fail);
+    EXPECT_THROW(j.get(), std::runtime_error);
+}
+
+TEST(Executor, CoAwait) {
+    fftw::executor pool{1};
+    gate blocker;
+
+    auto first = pool.submit(blocker);
+    blocker.wait_entered();
+    auto second = pool.submit(blocker);
+    std::promise<bool> first_result, second_result;
+    await_job(first, first_result);
+    await_job(second, second_result);
+
+    second.cancel();
+    EXPECT_FALSE(second_result.get_future().get());
+
+    blocker.release();
+    EXPECT_TRUE(first_result.get_future().get());
+}
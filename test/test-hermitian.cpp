@@ -0,0 +1,134 @@
+#include "fftw-cpp/fftw-cpp.h"
+#include "util.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+namespace stdex = std::experimental;
+
+namespace {
+
+double value(size_t i, size_t j) {
+    return std::cos(double(i * 5 + j * j) / 3.0) + 0.1 * double(j);
+}
+
+template <class View> std::vector<std::complex<double>> to_vector(const View &view) {
+    std::vector<std::complex<double>> values;
+    for (size_t i = 0; i < view.extent(0); ++i) {
+        for (size_t j = 0; j < view.extent(1); ++j) {
+            values.push_back(view(i, j));
+        }
+    }
+    return values;
+}
+
+} // namespace
+
+class Hermitian : public ::testing::TestWithParam<size_t> {};
+
+TEST_P(Hermitian, ExpandMatchesComplexTransform) {
+    const size_t N = 5, M = GetParam(), MK = M / 2 + 1;
+    fftw::rmdbuffer<2> real{N, M};
+    fftw::mdbuffer<2> complex{N, M}, expected{N, M}, full{N, M}, half{N, MK}, back{N, MK};
+    for (size_t i = 0; i < N; ++i) {
+        for (size_t j = 0; j < M; ++j) {
+            real(i, j) = value(i, j);
+            complex(i, j) = value(i, j);
+        }
+    }
+    fftw::plan_r2c<2u>::dft(real.to_mdspan(), half.to_mdspan(), fftw::ESTIMATE)();
+    fftw::plan<2u>::dft(complex.to_mdspan(), expected.to_mdspan(), fftw::FORWARD, fftw::ESTIMATE)();
+
+    fftw::expand_half_spectrum(half, full, 2);
+    EXPECT_THAT(to_vector(full.to_mdspan()),
+                ElementsAreComplexNear(to_vector(expected.to_mdspan())));
+
+    fftw::extract_half_spectrum(full, back);
+    EXPECT_THAT(to_vector(back.to_mdspan()), ElementsAreComplexNear(to_vector(half.to_mdspan())));
+}
+
+INSTANTIATE_TEST_SUITE_P(EvenAndOdd, Hermitian, ::testing::Values(6, 7));
+
+TEST(Hermitian, LayoutLeft) {
+    // the last dimension in FFTW order is the first extent of a layout_left view
+    const size_t N = 7, NK = N / 2 + 1, M = 4;
+    using d2 = stdex::dextents<size_t, 2>;
+    fftw::basic_rmdbuffer<double, d2, std::complex<double>, stdex::layout_left> real{N, M};
+    fftw::basic_mdbuffer<double, d2, std::complex<double>, stdex::layout_left> half{NK, M},
+        full{N, M}, complex{N, M}, expected{N, M};
+    for (size_t i = 0; i < N; ++i) {
+        for (size_t j = 0; j < M; ++j) {
+            real(i, j) = value(j, i);
+            complex(i, j) = value(j, i);
+        }
+    }
+    fftw::plan_r2c<2u>::dft(real.to_mdspan(), half.to_mdspan(), fftw::ESTIMATE)();
+    fftw::plan<2u>::dft(complex.to_mdspan(), expected.to_mdspan(), fftw::FORWARD, fftw::ESTIMATE)();
+
+    fftw::expand_half_spectrum(half, full);
+    EXPECT_THAT(to_vector(full.to_mdspan()),
+                ElementsAreComplexNear(to_vector(expected.to_mdspan())));
+}
+
+TEST(Hermitian, PowerMagnitudePhase) {
+    // several segments, split between threads
+    const size_t N = 3 * fftw::detail::hermitian_segment + 17;
+    fftw::buffer spectrum(N);
+    for (size_t i = 0; i < N; ++i) {
+        spectrum[i] = {std::cos(double(i)), std::sin(double(i * i) / 11.0) - 0.5};
+    }
+    stdex::mdspan<std::complex<double>, stdex::dextents<size_t, 1>> view{spectrum.data(), N};
+    std::vector<double> power(N), magnitude(N), phase(N), magnitude2(N), phase2(N);
+    using rview = stdex::mdspan<double, stdex::dextents<size_t, 1>>;
+
+    fftw::power_spectrum(view, rview{power.data(), N}, 3);
+    fftw::magnitude_spectrum(view, rview{magnitude.data(), N}, 3);
+    fftw::phase_spectrum(view, rview{phase.data(), N});
+    fftw::polar_spectrum(view, rview{magnitude2.data(), N}, rview{phase2.data(), N}, 4);
+    for (size_t i = 0; i < N; ++i) {
+        EXPECT_NEAR(power[i], std::norm(spectrum[i]), TOLERANCE);
+        EXPECT_NEAR(magnitude[i], std::abs(spectrum[i]), TOLERANCE);
+        EXPECT_NEAR(phase[i], std::arg(spectrum[i]), TOLERANCE);
+        EXPECT_EQ(magnitude2[i], magnitude[i]);
+        EXPECT_EQ(phase2[i], phase[i]);
+    }
+}
+
+TEST(Hermitian, StridedOutput) {
+    fftw::mdbuffer<2> spectrum{3, 4};
+    for (size_t i = 0; i < spectrum.size(); ++i) {
+        spectrum.data()[i] = {double(i), 1.0};
+    }
+    // every other column of a 3x8 array
+    std::vector<double> storage(24, -1.0);
+    using d2 = stdex::dextents<size_t, 2>;
+    stdex::mdspan<double, d2, stdex::layout_stride> power{
+        storage.data(), stdex::layout_stride::mapping<d2>{d2{3, 4}, std::array<size_t, 2>{8, 2}}};
+    fftw::power_spectrum(spectrum, power);
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            EXPECT_DOUBLE_EQ(power(i, j), std::norm(spectrum(i, j)));
+            EXPECT_EQ(storage[i * 8 + 2 * j + 1], -1.0);
+        }
+    }
+}
+
+TEST(Hermitian, Validates) {
+    fftw::mdbuffer<2> half{4, 3}, full{4, 6}, wrong{4, 7};
+    EXPECT_THROW(fftw::expand_half_spectrum(half, wrong), std::invalid_argument);
+    EXPECT_THROW(fftw::expand_half_spectrum(half, half), std::invalid_argument);
+    EXPECT_THROW(fftw::extract_half_spectrum(wrong, half), std::invalid_argument);
+
+    fftw::rmdbuffer<2> power{4, 4};
+    EXPECT_THROW(fftw::power_spectrum(half, power), std::invalid_argument);
+
+    // no rows, e.g. the spectrogram of a signal shorter than one frame
+    fftw::mdbuffer<2> empty_half{0, 5}, empty_full{0, 8}, empty_back{0, 5};
+    fftw::rmdbuffer<2> empty_magnitude{0, 5}, empty_phase{0, 5};
+    fftw::expand_half_spectrum(empty_half, empty_full, 4);
+    fftw::extract_half_spectrum(empty_full, empty_back, 4);
+    fftw::power_spectrum(empty_half, empty_magnitude, 4);
+    fftw::polar_spectrum(empty_half, empty_magnitude, empty_phase, 4);
+}
@@ -0,0 +1,110 @@
+#include "fftw-cpp/fftw-cpp.h"
+#include "util.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+
+namespace stdex = std::experimental;
+using d2 = stdex::dextents<std::size_t, 2u>;
+
+namespace {
+
+double field(std::size_t j, std::size_t k) {
+    return std::cos(2.0 * std::numbers::pi * double(j * k + 1) / 7.0) + 0.25 * double(j);
+}
+
+} // namespace
+
+TEST(PaddedLayout, Mapping) {
+    fftw::layout_r2c_padded::mapping<d2> odd{d2{3, 5}}, even{d2{3, 4}};
+
+    EXPECT_EQ(odd.padded_extent(), 6);
+    EXPECT_EQ(odd.stride(0), 6);
+    EXPECT_EQ(odd.stride(1), 1);
+    EXPECT_EQ(odd(2, 4), 16);
+    EXPECT_EQ(odd.required_span_size(), 18);
+
+    EXPECT_EQ(even.padded_extent(), 6);
+    EXPECT_EQ(even.required_span_size(), 18);
+}
+
+TEST(PaddedLayout, BufferViewsShareStorage) {
+    fftw::padded_mdbuffer<2> buf{4, 6};
+    auto r = buf.to_real_mdspan();
+    auto c = buf.to_complex_mdspan();
+
+    EXPECT_EQ(buf.size(), 4u * 4u);
+    EXPECT_EQ(static_cast<void *>(r.data_handle()), static_cast<void *>(c.data_handle()));
+    EXPECT_EQ(r.extent(0), 4u);
+    EXPECT_EQ(r.extent(1), 6u);
+    EXPECT_EQ(c.extent(0), 4u);
+    EXPECT_EQ(c.extent(1), 4u);
+
+    r(1, 2) = 3.0;
+    r(1, 3) = 4.0;
+    EXPECT_EQ(c(1, 1), std::complex<double>(3.0, 4.0));
+}
+
+TEST(InPlaceR2C, MatchesOutOfPlace) {
+    const std::size_t N = 4, M = 5, MK = M / 2 + 1;
+
+    fftw::rmdbuffer<2> in{N, M};
+    fftw::mdbuffer<2> expected{N, MK};
+    fftw::padded_mdbuffer<2> buf{N, M};
+    auto r = buf.to_real_mdspan();
+    for (std::size_t j = 0; j < N; ++j) {
+        for (std::size_t k = 0; k < M; ++k) {
+            in(j, k) = r(j, k) = field(j, k);
+        }
+    }
+
+    auto p = fftw::plan_r2c<2u>::dft(in.to_mdspan(), expected.to_mdspan(), fftw::ESTIMATE);
+    p();
+    auto p_inplace =
+        fftw::plan_r2c<2u>::dft(buf.to_real_mdspan(), buf.to_complex_mdspan(), fftw::ESTIMATE);
+    p_inplace();
+
+    std::span actual{buf.data(), buf.size()};
+    std::span expected_span{expected.data(), expected.size()};
+    EXPECT_THAT(actual, ElementsAreComplexNear(expected_span));
+}
+
+TEST(InPlaceR2C, RoundTrip) {
+    const std::size_t N = 3, M = 8;
+
+    fftw::padded_mdbuffer<2> buf{N, M};
+    auto r = buf.to_real_mdspan();
+    auto c = buf.to_complex_mdspan();
+    for (std::size_t j = 0; j < N; ++j) {
+        for (std::size_t k = 0; k < M; ++k) {
+            r(j, k) = field(j, k);
+        }
+    }
+
+    auto forward = fftw::plan_r2c<2u>::dft(r, c, fftw::ESTIMATE);
+    auto backward = fftw::plan_c2r<2u>::dft(c, r, fftw::ESTIMATE);
+    forward();
+    backward();
+
+    for (std::size_t j = 0; j < N; ++j) {
+        for (std::size_t k = 0; k < M; ++k) {
+            EXPECT_NEAR(r(j, k) / double(N * M), field(j, k), TOLERANCE) << j << ", " << k;
+        }
+    }
+}
+
+TEST(InPlaceR2C, RequiresPaddedLayout) {
+    const std::size_t N = 4, M = 6, MK = M / 2 + 1;
+
+    fftw::mdbuffer<2> storage{N, MK};
+    auto *real = reinterpret_cast<double *>(storage.data());
+    stdex::mdspan<double, d2> unpadded{real, N, M};
+
+    EXPECT_THROW(fftw::plan_r2c<2u>::dft(unpadded, storage.to_mdspan(), fftw::ESTIMATE),
+                 std::invalid_argument);
+    EXPECT_THROW(fftw::plan_c2r<2u>::dft(storage.to_mdspan(), unpadded, fftw::ESTIMATE),
+                 std::invalid_argument);
+}
@@ -0,0 +1,65 @@
+#include "fftw-cpp/fftw-cpp.h"
+
+#include <gtest/gtest.h>
+#include <numeric>
+#include <string>
+
+TEST(Introspection, FlopsCostAndDescription) {
+    const size_t N = 64;
+    fftw::buffer in(N), out(N);
+    auto p = fftw::plan<1u>::dft(in, out, fftw::FORWARD, fftw::ESTIMATE);
+
+    auto flops = p.flops();
+    EXPECT_GT(flops.total(), 0.0);
+    EXPECT_DOUBLE_EQ(flops.total(), flops.add + flops.mul + 2.0 * flops.fma);
+    EXPECT_GT(p.estimate_cost(), 0.0);
+    EXPECT_GE(p.cost(), 0.0);
+    EXPECT_FALSE(p.to_string().empty());
+
+    fftw::plan<1u> empty;
+    EXPECT_THROW((void)empty.flops(), std::logic_error);
+}
+
+TEST(Instrumentation, RecordsExecutions) {
+    fftw::clear_instrumentation();
+    const size_t N = 32;
+    fftw::buffer in(N), out(N);
+    fftw::rbuffer real(N);
+    auto p = fftw::plan<1u>::dft(in, out, fftw::FORWARD, fftw::ESTIMATE);
+    auto quiet = fftw::plan<1u>::dft(in, out, fftw::BACKWARD, fftw::ESTIMATE);
+    auto r2r = fftw::plan_r2r<1u>::dft(real, real, fftw::R2RKind::DHT, fftw::ESTIMATE);
+
+    EXPECT_EQ(p.stats().calls, 0u);
+    p.instrument("c2c \"forward\" 32");
+    r2r.instrument("dht 32");
+    for (int i = 0; i < 5; ++i) {
+        p();
+    }
+    p(in, out);
+    quiet();
+    r2r(real, real);
+
+    auto stats = p.stats();
+    EXPECT_EQ(stats.name, "c2c \"forward\" 32");
+    EXPECT_EQ(stats.plan, p.to_string());
+    EXPECT_EQ(stats.calls, 6u);
+    EXPECT_EQ(std::accumulate(stats.histogram.begin(), stats.histogram.end(), size_t{0}), 6u);
+    EXPECT_LE(stats.min_seconds, stats.mean_seconds());
+    EXPECT_LE(stats.mean_seconds(), stats.max_seconds);
+    EXPECT_DOUBLE_EQ(stats.flops, p.flops().total());
+    EXPECT_GE(stats.gflops(), 0.0);
+
+    auto all = fftw::instrumentation_snapshot();
+    ASSERT_EQ(all.size(), 2u);
+    EXPECT_EQ(all[1].calls, 1u);
+
+    auto json = fftw::instrumentation_json();
+    EXPECT_NE(json.find(R"("name": "c2c \"forward\" 32")"), std::string::npos);
+    EXPECT_NE(json.find(R"("calls": 6)"), std::string::npos);
+    EXPECT_NE(json.find(R"("name": "dht 32")"), std::string::npos);
+
+    fftw::reset_instrumentation();
+    EXPECT_EQ(p.stats().calls, 0u);
+    fftw::clear_instrumentation();
+    EXPECT_EQ(fftw::instrumentation_json(), "[]\n");
+}
@@ -0,0 +1,122 @@
+#include "fftw-cpp/fftw-cpp.h"
+#include "util.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <numbers>
+
+namespace stdex = std::experimental;
+using d1 = stdex::dextents<std::size_t, 1u>;
+using d2 = stdex::dextents<std::size_t, 2u>;
+
+namespace {
+std::complex<double> sample(std::size_t j, std::size_t k) {
+    return {std::cos(2.0 * std::numbers::pi * double((j + 1) * k) / 11.0),
+            std::sin(double(j) - double(k) / 5.0)};
+}
+} // namespace
+
+TEST(StridedLayouts, ColumnOfMatrixInPlace) {
+    std::size_t N = 8, M = 5, col = 2;
+    fftw::mdbuffer<2u> matrix{N, M};
+    for (std::size_t j = 0; j < N; ++j) {
+        for (std::size_t k = 0; k < M; ++k) {
+            matrix(j, k) = sample(j, k);
+        }
+    }
+
+    fftw::buffer expected_in(N), expected(N);
+    for (std::size_t j = 0; j < N; ++j) {
+        expected_in[j] = matrix(j, col);
+    }
+    fftw::plan<1u>::dft(expected_in, expected, fftw::FORWARD, fftw::ESTIMATE)();
+
+    // a single column, transformed in place without leaving the matrix
+    stdex::mdspan<std::complex<double>, d1, stdex::layout_stride> column{
+        &matrix(0, col), stdex::layout_stride::mapping<d1>{d1{N}, std::array<std::size_t, 1>{M}}};
+    auto p = fftw::plan<1u>::dft(column, column, fftw::FORWARD, fftw::ESTIMATE);
+    p();
+
+    for (std::size_t j = 0; j < N; ++j) {
+        EXPECT_THAT(column(j), IsComplexNear(expected[j]));
+        // other columns are untouched
+        EXPECT_THAT(matrix(j, col + 1), IsComplexNear(sample(j, col + 1)));
+    }
+}
+
+TEST(StridedLayouts, LayoutLeftMatchesLayoutRight) {
+    std::size_t N = 4, M = 6;
+    fftw::mdbuffer<2u> in_r{N, M}, out_r{N, M};
+    fftw::mdbuffer<2u, fftw::layout_left> in_l{N, M}, out_l{N, M};
+    fftw::mdbuffer<2u> out_mixed{M, N};
+
+    for (std::size_t j = 0; j < N; ++j) {
+        for (std::size_t k = 0; k < M; ++k) {
+            in_r(j, k) = in_l(j, k) = sample(j, k);
+        }
+    }
+
+    fftw::plan<2u>::dft(in_r, out_r, fftw::FORWARD, fftw::ESTIMATE)();
+    fftw::plan<2u>::dft(in_l.to_mdspan(), out_l.to_mdspan(), fftw::FORWARD, fftw::ESTIMATE)();
+    // layout_left into layout_right keeps memory order, so the output is transposed
+    fftw::plan<2u>::dft(in_l.to_mdspan(), out_mixed.to_mdspan(), fftw::FORWARD, fftw::ESTIMATE)();
+
+    for (std::size_t j = 0; j < N; ++j) {
+        for (std::size_t k = 0; k < M; ++k) {
+            EXPECT_THAT(out_l(j, k), IsComplexNear(out_r(j, k)));
+            EXPECT_THAT(out_mixed(k, j), IsComplexNear(out_r(j, k)));
+        }
+    }
+}
+
+TEST(StridedLayouts, SubBlockR2C) {
+    // a 4x6 block at offset (1, 2) of a 7x10 real array
+    std::size_t N = 4, M = 6, NK = M / 2 + 1, LD = 10;
+    fftw::rmdbuffer<2u> big{7, LD}, block_copy{N, M}, out2{N, M};
+    fftw::mdbuffer<2u> out{N, NK}, expected{N, NK};
+
+    for (std::size_t j = 0; j < big.extent(0); ++j) {
+        for (std::size_t k = 0; k < big.extent(1); ++k) {
+            big(j, k) = sample(j, k).real();
+        }
+    }
+    for (std::size_t j = 0; j < N; ++j) {
+        for (std::size_t k = 0; k < M; ++k) {
+            block_copy(j, k) = big(j + 1, k + 2);
+        }
+    }
+
+    stdex::mdspan<double, d2, stdex::layout_stride> block{
+        &big(1, 2), stdex::layout_stride::mapping<d2>{d2{N, M}, std::array<std::size_t, 2>{LD, 1}}};
+
+    fftw::plan_r2c<2u>::dft(block_copy.to_mdspan(), expected.to_mdspan(), fftw::ESTIMATE)();
+    auto p = fftw::plan_r2c<2u>::dft(block, out.to_mdspan(), fftw::ESTIMATE);
+    p();
+
+    for (std::size_t j = 0; j < N; ++j) {
+        for (std::size_t k = 0; k < NK; ++k) {
+            EXPECT_THAT(out(j, k), IsComplexNear(expected(j, k)));
+        }
+    }
+
+    // and back into the block, overwriting it with the scaled original
+    auto pInv = fftw::plan_c2r<2u>::dft(out.to_mdspan(), block, fftw::ESTIMATE);
+    pInv();
+    for (std::size_t j = 0; j < N; ++j) {
+        for (std::size_t k = 0; k < M; ++k) {
+            EXPECT_NEAR(block(j, k) / double(N * M), block_copy(j, k), TOLERANCE);
+        }
+    }
+    EXPECT_NEAR(big(0, 0), sample(0, 0).real(), TOLERANCE);
+    EXPECT_NEAR(big(1, 1), sample(1, 1).real(), TOLERANCE);
+}
+
+TEST(StridedLayouts, ValidatesExtents) {
+    fftw::mdbuffer<2u> a{4, 6};
+    fftw::mdbuffer<2u, fftw::layout_left> b{6, 4};
+    stdex::mdspan<std::complex<double>, d2, stdex::layout_stride> strided{
+        a.data(), stdex::layout_stride::mapping<d2>{d2{6, 4}, std::array<std::size_t, 2>{4, 1}}};
+
+    EXPECT_THROW(fftw::plan<2u>::dft(strided, b.to_mdspan(), fftw::FORWARD, fftw::ESTIMATE),
+                 std::invalid_argument);
+}
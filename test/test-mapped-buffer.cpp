@@ -0,0 +1,115 @@
+#include "fftw-cpp/fftw-cpp.h"
+#include "util.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <numbers>
+#include <system_error>
+#include <vector>
+
+namespace {
+
+void write_doubles(const std::filesystem::path &path, const std::vector<double> &values) {
+    std::ofstream file{path, std::ios::binary};
+    file.write(reinterpret_cast<const char *>(values.data()),
+               std::streamsize(values.size() * sizeof(double)));
+}
+
+std::vector<double> read_doubles(const std::filesystem::path &path) {
+    std::vector<double> values(std::filesystem::file_size(path) / sizeof(double));
+    std::ifstream file{path, std::ios::binary};
+    file.read(reinterpret_cast<char *>(values.data()),
+              std::streamsize(values.size() * sizeof(double)));
+    return values;
+}
+
+} // namespace
+
+TEST(HugePages, LargeBufferTransforms) {
+    // 4 MiB of complex doubles, so the huge page path is taken; only the start is transformed
+    const size_t size = size_t{1} << 18, N = 64;
+    fftw::huge_buffer in(size), out(size);
+    fftw::buffer expected(N);
+    EXPECT_TRUE(fftw::buffer_view{in}.is_simd_aligned());
+    EXPECT_TRUE(fftw::buffer_view{out}.is_simd_aligned());
+
+    fftw::buffer_view in_view{in.data(), N}, out_view{out.data(), N};
+    for (size_t i = 0; i < N; ++i) {
+        in[i] = {std::cos(double(i)), 0.5};
+    }
+    auto p = fftw::plan<1u>::dft(in_view, out_view, fftw::FORWARD, fftw::ESTIMATE);
+    p();
+
+    fftw::buffer in_copy(N);
+    std::copy_n(in.begin(), N, in_copy.begin());
+    fftw::plan<1u>::dft(in_copy, expected, fftw::FORWARD, fftw::ESTIMATE)();
+
+    EXPECT_THAT(std::span(out.data(), N), ElementsAreComplexNear(expected));
+    in[size - 1] = {1.0, 1.0}; // the whole mapping is usable
+}
+
+TEST(HugePages, MdbufferAndSmallAllocations) {
+    fftw::huge_mdbuffer<2> big{512, 512};
+    fftw::huge_rmdbuffer<2> small{4, 4};
+    big(511, 511) = {1.0, 2.0};
+    small(3, 3) = 3.0;
+    EXPECT_EQ(big(511, 511), std::complex<double>(1.0, 2.0));
+    EXPECT_EQ(small(3, 3), 3.0);
+}
+
+TEST(MappedFile, TransformsStraightFromDisk) {
+    const size_t N = 8, M = 16, MK = M / 2 + 1;
+    auto input_path = temp_path("fftw-cpp-mapped-in.f64");
+    auto output_path = temp_path("fftw-cpp-mapped-out.c128");
+
+    std::vector<double> field(N * M);
+    for (size_t i = 0; i < field.size(); ++i) {
+        field[i] = std::sin(2.0 * std::numbers::pi * double(i) / double(M));
+    }
+    write_doubles(input_path, field);
+
+    fftw::rmdbuffer<2> in{N, M};
+    fftw::mdbuffer<2> expected{N, MK};
+    std::copy(field.begin(), field.end(), in.data());
+    fftw::plan_r2c<2u>::dft(in.to_mdspan(), expected.to_mdspan(), fftw::ESTIMATE)();
+
+    {
+        fftw::rmapped_file input{input_path, fftw::map_mode::READ};
+        fftw::mapped_file output{output_path, fftw::map_mode::CREATE, N * MK};
+        ASSERT_EQ(input.size(), N * M);
+        EXPECT_TRUE(input.view().is_simd_aligned());
+
+        auto p = fftw::plan_r2c<2u>::dft(input.to_mdspan(N, M), output.to_mdspan(N, MK),
+                                         fftw::ESTIMATE);
+        p();
+        output.sync();
+
+        // writes to a READ mapping never reach the file
+        input.data()[0] = 42.0;
+    }
+    EXPECT_EQ(read_doubles(input_path), field);
+
+    fftw::mapped_file result{output_path, fftw::map_mode::READ_WRITE};
+    ASSERT_EQ(result.size(), N * MK);
+    std::span actual{result.data(), result.size()};
+    std::span expected_span{expected.data(), expected.size()};
+    EXPECT_THAT(actual, ElementsAreComplexNear(expected_span));
+
+    std::filesystem::remove(input_path);
+    std::filesystem::remove(output_path);
+}
+
+TEST(MappedFile, Validates) {
+    auto path = temp_path("fftw-cpp-mapped-odd.bin");
+    write_doubles(path, {1.0, 2.0, 3.0});
+
+    EXPECT_THROW(fftw::mapped_file(path, fftw::map_mode::READ), std::invalid_argument);
+    fftw::rmapped_file file{path, fftw::map_mode::READ};
+    EXPECT_THROW(file.to_mdspan(2, 2), std::invalid_argument);
+    EXPECT_THROW(fftw::rmapped_file(temp_path("fftw-cpp-missing.bin"), fftw::map_mode::READ),
+                 std::system_error);
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,207 @@
+#include "fftw-cpp/fftw-cpp.h"
+#include "util.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <mpi.h>
+#include <vector>
+
+// Every process builds the whole input deterministically, transforms it with a serial plan and
+// compares its own slab of the distributed result against the serial one.
+
+namespace {
+
+std::complex<double> value(size_t i, size_t j, size_t k) {
+    return {std::cos(double(i * 7 + j * 3 + k)), std::sin(double(i + 2 * j * k))};
+}
+
+template <class View> std::vector<std::complex<double>> to_vector(View view) {
+    std::vector<std::complex<double>> values;
+    for (size_t i = 0; i < view.extent(0); ++i) {
+        for (size_t j = 0; j < view.extent(1); ++j) {
+            values.push_back(view(i, j));
+        }
+    }
+    return values;
+}
+
+static_assert(unsigned(fftw::MEASURE | fftw::TRANSPOSED_OUT) ==
+              (FFTW_MEASURE | FFTW_MPI_TRANSPOSED_OUT));
+
+} // namespace
+
+TEST(MPI, C2C3DMatchesSerial) {
+    const size_t N0 = 5, N1 = 4, N2 = 6;
+    auto dist = fftw::mpi_plan<3>::local_size({N0, N1, N2}, MPI_COMM_WORLD);
+    ASSERT_GE(dist.alloc_local, size_t(dist.local_n0) * N1 * N2);
+
+    fftw::mdbuffer<3> global{N0, N1, N2}, expected{N0, N1, N2};
+    for (size_t i = 0; i < N0; ++i) {
+        for (size_t j = 0; j < N1; ++j) {
+            for (size_t k = 0; k < N2; ++k) {
+                global(i, j, k) = value(i, j, k);
+            }
+        }
+    }
+    fftw::plan<3u>::dft(global.to_mdspan(), expected.to_mdspan(), fftw::FORWARD, fftw::ESTIMATE)();
+
+    fftw::buffer local(dist.alloc_local);
+    auto view = dist.complex_view(local.data());
+    auto p =
+        fftw::mpi_plan<3>::dft(view, view, dist, MPI_COMM_WORLD, fftw::FORWARD, fftw::ESTIMATE);
+    for (size_t i = 0; i < view.extent(0); ++i) {
+        for (size_t j = 0; j < N1; ++j) {
+            for (size_t k = 0; k < N2; ++k) {
+                view(i, j, k) = global(size_t(dist.local_0_start) + i, j, k);
+            }
+        }
+    }
+    p();
+
+    std::span actual{local.data(), size_t(dist.local_n0) * N1 * N2};
+    std::span slab{expected.data() + dist.local_0_start * N1 * N2, actual.size()};
+    EXPECT_THAT(actual, ElementsAreComplexNear(slab));
+}
+
+TEST(MPI, TransposedRoundTrip) {
+    const size_t N0 = 6, N1 = 5;
+    auto dist = fftw::mpi_plan<2>::local_size({N0, N1}, MPI_COMM_WORLD);
+
+    fftw::mdbuffer<2> global{N0, N1}, expected{N0, N1};
+    for (size_t i = 0; i < N0; ++i) {
+        for (size_t j = 0; j < N1; ++j) {
+            global(i, j) = value(i, j, 1);
+        }
+    }
+    fftw::plan<2u>::dft(global.to_mdspan(), expected.to_mdspan(), fftw::FORWARD, fftw::ESTIMATE)();
+
+    fftw::buffer data(dist.alloc_local), spectrum(dist.alloc_local);
+    auto in = dist.complex_view(data.data());
+    auto out = dist.complex_view(spectrum.data(), true);
+    EXPECT_EQ(out.extent(0), size_t(dist.local_n1));
+    EXPECT_EQ(out.extent(1), N0);
+
+    auto forward = fftw::mpi_plan<2>::dft(in, out, dist, MPI_COMM_WORLD, fftw::FORWARD,
+                                          fftw::ESTIMATE | fftw::TRANSPOSED_OUT);
+    auto backward = fftw::mpi_plan<2>::dft(out, in, dist, MPI_COMM_WORLD, fftw::BACKWARD,
+                                           fftw::ESTIMATE | fftw::TRANSPOSED_IN);
+    for (size_t i = 0; i < in.extent(0); ++i) {
+        for (size_t j = 0; j < N1; ++j) {
+            in(i, j) = global(size_t(dist.local_0_start) + i, j);
+        }
+    }
+    auto original = to_vector(in);
+
+    forward();
+    std::vector<std::complex<double>> transposed;
+    for (size_t j = 0; j < out.extent(0); ++j) {
+        for (size_t i = 0; i < N0; ++i) {
+            transposed.push_back(expected(i, size_t(dist.local_1_start) + j));
+        }
+    }
+    EXPECT_THAT(to_vector(out), ElementsAreComplexNear(transposed));
+
+    backward();
+    for (auto &x : original) {
+        x *= double(N0 * N1);
+    }
+    EXPECT_THAT(to_vector(in), ElementsAreComplexNear(original));
+}
+
+TEST(MPI, R2CAndC2R) {
+    const size_t N0 = 5, N1 = 6, NK = N1 / 2 + 1;
+    auto dist = fftw::mpi_plan_r2c<2>::local_size({N0, N1}, MPI_COMM_WORLD);
+
+    fftw::rmdbuffer<2> global{N0, N1};
+    fftw::mdbuffer<2> expected{N0, NK};
+    for (size_t i = 0; i < N0; ++i) {
+        for (size_t j = 0; j < N1; ++j) {
+            global(i, j) = value(i, j, 2).real();
+        }
+    }
+    fftw::plan_r2c<2u>::dft(global.to_mdspan(), expected.to_mdspan(), fftw::ESTIMATE)();
+
+    // in-place: the padded real view and the complex view share the buffer
+    fftw::buffer data(dist.alloc_local);
+    auto real = dist.real_view(reinterpret_cast<double *>(data.data()));
+    auto complex = dist.complex_view(data.data());
+    EXPECT_EQ(complex.extent(1), NK);
+
+    auto forward = fftw::mpi_plan_r2c<2>::dft(real, complex, dist, MPI_COMM_WORLD, fftw::ESTIMATE);
+    auto backward = fftw::mpi_plan_c2r<2>::dft(complex, real, dist, MPI_COMM_WORLD, fftw::ESTIMATE);
+    for (size_t i = 0; i < real.extent(0); ++i) {
+        for (size_t j = 0; j < N1; ++j) {
+            real(i, j) = global(size_t(dist.local_0_start) + i, j);
+        }
+    }
+
+    forward();
+    std::span slab{expected.data() + dist.local_0_start * NK, size_t(dist.local_n0) * NK};
+    EXPECT_THAT(to_vector(complex), ElementsAreComplexNear(slab));
+
+    backward();
+    for (size_t i = 0; i < real.extent(0); ++i) {
+        for (size_t j = 0; j < N1; ++j) {
+            EXPECT_NEAR(real(i, j), double(N0 * N1) * global(size_t(dist.local_0_start) + i, j),
+                        TOLERANCE);
+        }
+    }
+}
+
+TEST(MPI, Validates) {
+    auto dist = fftw::mpi_plan<2>::local_size({4, 4}, MPI_COMM_WORLD);
+    auto real_dist = fftw::mpi_plan_r2c<2>::local_size({4, 4}, MPI_COMM_WORLD);
+    fftw::buffer data(dist.alloc_local + 16);
+    auto view = dist.complex_view(data.data());
+
+    fftw::mdbuffer<2> wrong{size_t(dist.local_n0), 3};
+    EXPECT_THROW(fftw::mpi_plan<2>::dft(wrong.to_mdspan(), view, dist, MPI_COMM_WORLD,
+                                        fftw::FORWARD, fftw::ESTIMATE),
+                 std::invalid_argument);
+    EXPECT_THROW(fftw::mpi_plan<2>::dft(view, view, real_dist, MPI_COMM_WORLD, fftw::FORWARD,
+                                        fftw::ESTIMATE),
+                 std::invalid_argument);
+    EXPECT_THROW((void)dist.real_view(reinterpret_cast<double *>(data.data())), std::logic_error);
+    EXPECT_THROW(fftw::mpi_plan<2>::local_size({0, 4}, MPI_COMM_WORLD), std::invalid_argument);
+}
+
+TEST(MPI, PlansAfterGuard) {
+    // a guard released fftw3-mpi; the next distributed plan initializes it again
+    { fftw::mpi_guard guard; }
+
+    const size_t N0 = 4, N1 = 6;
+    auto dist = fftw::mpi_plan<2>::local_size({N0, N1}, MPI_COMM_WORLD);
+    fftw::mdbuffer<2> global{N0, N1}, expected{N0, N1};
+    for (size_t i = 0; i < N0; ++i) {
+        for (size_t j = 0; j < N1; ++j) {
+            global(i, j) = value(i, j, 3);
+        }
+    }
+    fftw::plan<2u>::dft(global.to_mdspan(), expected.to_mdspan(), fftw::FORWARD, fftw::ESTIMATE)();
+
+    fftw::buffer data(dist.alloc_local);
+    auto view = dist.complex_view(data.data());
+    auto p =
+        fftw::mpi_plan<2>::dft(view, view, dist, MPI_COMM_WORLD, fftw::FORWARD, fftw::ESTIMATE, 2);
+    for (size_t i = 0; i < view.extent(0); ++i) {
+        for (size_t j = 0; j < N1; ++j) {
+            view(i, j) = global(size_t(dist.local_0_start) + i, j);
+        }
+    }
+    p();
+
+    std::span slab{expected.data() + dist.local_0_start * N1, size_t(dist.local_n0) * N1};
+    EXPECT_THAT(to_vector(view), ElementsAreComplexNear(slab));
+}
+
+int main(int argc, char **argv) {
+    MPI_Init(&argc, &argv);
+    int result = 0;
+    {
+        fftw::mpi_guard guard;
+        ::testing::InitGoogleTest(&argc, argv);
+        result = RUN_ALL_TESTS();
+    }
+    MPI_Finalize();
+    return result;
+}
@@ -0,0 +1,136 @@
+#include "fftw-cpp/fftw-cpp.h"
+#include "util.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <array>
+#include <numbers>
+#include <vector>
+
+namespace {
+
+/// Naive multi-dimensional DFT of row-major data, used as the reference.
+template <size_t D>
+std::vector<std::complex<double>> naive_dft(const std::vector<std::complex<double>> &in,
+                                            const std::array<std::size_t, D> &n, int sign) {
+    std::size_t size = in.size();
+    std::vector<std::complex<double>> out(size);
+
+    auto unflatten = [&](std::size_t flat) {
+        std::array<std::size_t, D> idx{};
+        for (std::size_t d = D; d-- > 0;) {
+            idx[d] = flat % n[d];
+            flat /= n[d];
+        }
+        return idx;
+    };
+
+    for (std::size_t k = 0; k < size; ++k) {
+        auto kk = unflatten(k);
+        std::complex<double> sum{};
+        for (std::size_t j = 0; j < size; ++j) {
+            auto jj = unflatten(j);
+            double phase = 0.0;
+            for (std::size_t d = 0; d < D; ++d) {
+                phase += double(jj[d] * kk[d]) / double(n[d]);
+            }
+            sum += in[j] * std::polar(1.0, sign * 2.0 * std::numbers::pi * phase);
+        }
+        out[k] = sum;
+    }
+    return out;
+}
+
+template <size_t D> constexpr std::array<std::size_t, D> test_extents() {
+    if constexpr (D == 1) {
+        return {12};
+    } else if constexpr (D == 2) {
+        return {4, 6};
+    } else if constexpr (D == 3) {
+        return {3, 4, 6};
+    } else {
+        return {2, 3, 2, 4};
+    }
+}
+
+template <class MdBuffer, size_t D> MdBuffer make(const std::array<std::size_t, D> &n) {
+    return std::apply([](auto... e) { return MdBuffer{e...}; }, n);
+}
+
+} // namespace
+
+template <typename Rank> class NdTransform : public ::testing::Test {};
+
+using Ranks = ::testing::Types<std::integral_constant<size_t, 1>, std::integral_constant<size_t, 2>,
+                               std::integral_constant<size_t, 3>,
+                               std::integral_constant<size_t, 4>>;
+TYPED_TEST_SUITE(NdTransform, Ranks);
+
+TYPED_TEST(NdTransform, C2CMatchesNaive) {
+    constexpr size_t D = TypeParam::value;
+    auto n = test_extents<D>();
+    auto in = make<fftw::mdbuffer<D>>(n);
+    auto out = make<fftw::mdbuffer<D>>(n);
+
+    std::vector<std::complex<double>> data(in.size());
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = {std::cos(double(i) / 3.0), std::sin(double(i * i) / 7.0)};
+    }
+    std::ranges::copy(data, in.data());
+
+    auto p = fftw::plan<D>::dft(in.to_mdspan(), out.to_mdspan(), fftw::FORWARD, fftw::ESTIMATE);
+    p();
+
+    std::span out_span{out.data(), out.size()};
+    EXPECT_THAT(out_span, ElementsAreComplexNear(naive_dft<D>(data, n, -1)));
+
+    auto pInv = fftw::plan<D>::dft(out, in, fftw::BACKWARD, fftw::ESTIMATE);
+    pInv();
+    std::span in_span{in.data(), in.size()};
+    EXPECT_THAT(in_span, ElementsAreComplexNear(naive_dft<D>(naive_dft<D>(data, n, -1), n, 1)));
+}
+
+TYPED_TEST(NdTransform, R2CMatchesNaiveAndRoundTrips) {
+    constexpr size_t D = TypeParam::value;
+    auto n = test_extents<D>();
+    auto nc = n;
+    nc[D - 1] = n[D - 1] / 2 + 1;
+
+    auto in = make<fftw::rmdbuffer<D>>(n);
+    auto out2 = make<fftw::rmdbuffer<D>>(n);
+    auto out = make<fftw::mdbuffer<D>>(nc);
+
+    std::vector<std::complex<double>> data(in.size());
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = std::cos(double(i) / 3.0) + double(i % 5);
+        in.data()[i] = data[i].real();
+    }
+
+    auto p = fftw::plan_r2c<D>::dft(in.to_mdspan(), out.to_mdspan(), fftw::ESTIMATE);
+    auto pInv = fftw::plan_c2r<D>::dft(out.to_mdspan(), out2.to_mdspan(), fftw::ESTIMATE);
+    p();
+
+    // the half spectrum is the full spectrum with the last index truncated
+    auto full = naive_dft<D>(data, n, -1);
+    std::vector<std::complex<double>> half;
+    for (std::size_t i = 0; i < full.size(); ++i) {
+        if (i % n[D - 1] < nc[D - 1]) { half.push_back(full[i]); }
+    }
+    std::span out_span{out.data(), out.size()};
+    EXPECT_THAT(out_span, ElementsAreComplexNear(half));
+
+    pInv();
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        EXPECT_NEAR(out2.data()[i] / double(in.size()), in.data()[i], TOLERANCE);
+    }
+}
+
+TEST(NdTransform, ValidatesR2CExtents) {
+    fftw::rmdbuffer<3u> in{3, 4, 6};
+    fftw::mdbuffer<3u> wrong_last{3, 4, 3}, wrong_first{2, 4, 4};
+
+    EXPECT_THROW(fftw::plan_r2c<3u>::dft(in.to_mdspan(), wrong_last.to_mdspan(), fftw::ESTIMATE),
+                 std::invalid_argument);
+    EXPECT_THROW(fftw::plan_r2c<3u>::dft(in.to_mdspan(), wrong_first.to_mdspan(), fftw::ESTIMATE),
+                 std::invalid_argument);
+}
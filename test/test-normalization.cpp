@@ -0,0 +1,131 @@
+#include "fftw-cpp/fftw-cpp.h"
+#include "util.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <numbers>
+#include <span>
+#include <vector>
+
+namespace stdex = std::experimental;
+using d1 = stdex::dextents<std::size_t, 1u>;
+
+namespace {
+
+void fill(fftw::buffer &buf) {
+    for (size_t i = 0; i < buf.size(); ++i) {
+        buf[i] = {std::cos(double(i) / 3.0), std::sin(double(i * i) / 7.0)};
+    }
+}
+
+} // namespace
+
+TEST(Normalization, BackwardInvertsForward) {
+    const size_t N = 20;
+    fftw::buffer in(N), spectrum(N), back(N);
+    fill(in);
+
+    auto forward = fftw::plan<1u>::dft(in, spectrum, fftw::FORWARD, fftw::ESTIMATE);
+    auto backward = fftw::plan<1u>::dft(spectrum, back, fftw::BACKWARD, fftw::ESTIMATE);
+    forward.normalize(fftw::normalization::BACKWARD);
+    backward.normalize(fftw::normalization::BACKWARD);
+    EXPECT_EQ(forward.scale_factor(), 1.0);
+    EXPECT_DOUBLE_EQ(backward.scale_factor(), 1.0 / double(N));
+
+    forward();
+    backward();
+    EXPECT_THAT(back, ElementsAreComplexNear(in));
+}
+
+TEST(Normalization, ForwardAndOrtho) {
+    const size_t N = 16;
+    fftw::buffer ones(N), spectrum(N);
+    std::fill(ones.begin(), ones.end(), std::complex<double>{1.0});
+
+    auto p = fftw::plan<1u>::dft(ones, spectrum, fftw::FORWARD, fftw::ESTIMATE);
+    p.normalize(fftw::normalization::FORWARD);
+    p();
+    EXPECT_THAT(spectrum[0], IsComplexNear(std::complex<double>{1.0}));
+
+    // unitary: the norm is preserved
+    p.normalize(fftw::normalization::ORTHO);
+    fftw::buffer in(N), out(N);
+    fill(in);
+    p(in, out);
+    double in_norm = 0.0, out_norm = 0.0;
+    for (size_t i = 0; i < N; ++i) {
+        in_norm += std::norm(in[i]);
+        out_norm += std::norm(out[i]);
+    }
+    EXPECT_NEAR(in_norm, out_norm, TOLERANCE);
+
+    p.normalize(fftw::normalization::NONE);
+    p();
+    EXPECT_THAT(spectrum[0], IsComplexNear(std::complex<double>{double(N)}));
+}
+
+TEST(Normalization, RealRoundTrip) {
+    const size_t N = 6, M = 10, MK = M / 2 + 1;
+    fftw::rmdbuffer<2> in{N, M}, back{N, M}, back2{N, M};
+    fftw::mdbuffer<2> spectrum{N, MK};
+    for (size_t i = 0; i < N; ++i) {
+        for (size_t j = 0; j < M; ++j) {
+            in(i, j) = std::cos(2.0 * std::numbers::pi * double(i * j) / double(M)) + double(i);
+        }
+    }
+
+    auto forward = fftw::plan_r2c<2u>::dft(in.to_mdspan(), spectrum.to_mdspan(), fftw::ESTIMATE);
+    auto backward =
+        fftw::plan_c2r<2u>::dft(spectrum.to_mdspan(), back.to_mdspan(), fftw::ESTIMATE);
+    forward.normalize(fftw::normalization::ORTHO);
+    backward.normalize(fftw::normalization::ORTHO);
+
+    forward();
+    backward();
+    std::span expected{in.data(), in.size()};
+    EXPECT_THAT(std::span(back.data(), back.size()), ElementsAreComplexNear(expected));
+
+    // new-array execution is scaled too (c2r destroys its input, so transform again first)
+    forward();
+    backward(spectrum.to_mdspan(), back2.to_mdspan());
+    EXPECT_THAT(std::span(back2.data(), back2.size()), ElementsAreComplexNear(expected));
+}
+
+TEST(Normalization, AxesUseTheirOwnSize) {
+    const size_t N = 4, M = 8;
+    fftw::mdbuffer<2> data{N, M}, expected{N, M};
+    for (size_t i = 0; i < N * M; ++i) {
+        data.data()[i] = expected.data()[i] = {double(i % 7), 1.0};
+    }
+
+    auto forward = fftw::plan<2u>::dft_axes(data.to_mdspan(), data.to_mdspan(), {1},
+                                            fftw::FORWARD, fftw::ESTIMATE);
+    auto backward = fftw::plan<2u>::dft_axes(data.to_mdspan(), data.to_mdspan(), {1},
+                                             fftw::BACKWARD, fftw::ESTIMATE);
+    backward.normalize(fftw::normalization::BACKWARD);
+    EXPECT_DOUBLE_EQ(backward.scale_factor(), 1.0 / double(M));
+    forward();
+    backward();
+    EXPECT_THAT(std::span(data.data(), data.size()),
+                ElementsAreComplexNear(std::span(expected.data(), expected.size())));
+}
+
+TEST(Normalization, StridedOutputLeavesGapsAlone) {
+    const size_t N = 8, M = 3;
+    fftw::mdbuffer<2> matrix{N, M};
+    for (size_t i = 0; i < N * M; ++i) {
+        matrix.data()[i] = {1.0, 0.0};
+    }
+    stdex::mdspan<std::complex<double>, d1, stdex::layout_stride> column{
+        &matrix(0, 1), stdex::layout_stride::mapping<d1>{d1{N}, std::array<std::size_t, 1>{M}}};
+
+    auto p = fftw::plan<1u>::dft(column, column, fftw::BACKWARD, fftw::ESTIMATE);
+    p.normalize(fftw::normalization::BACKWARD);
+    p();
+
+    EXPECT_THAT(column(0), IsComplexNear(std::complex<double>{1.0}));
+    for (size_t i = 0; i < N; ++i) {
+        EXPECT_EQ(matrix(i, 0), std::complex<double>(1.0));
+        EXPECT_EQ(matrix(i, 2), std::complex<double>(1.0));
+    }
+}
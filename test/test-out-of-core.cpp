@@ -0,0 +1,104 @@
+#include "fftw-cpp/fftw-cpp.h"
+#include "util.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <span>
+#include <vector>
+
+namespace {
+
+void write_complex(const std::filesystem::path &path, const fftw::mdbuffer<2> &values) {
+    std::ofstream file{path, std::ios::binary};
+    file.write(reinterpret_cast<const char *>(values.data()),
+               std::streamsize(values.size() * sizeof(std::complex<double>)));
+}
+
+std::vector<std::complex<double>> read_complex(const std::filesystem::path &path, size_t size) {
+    std::vector<std::complex<double>> values(size);
+    std::ifstream file{path, std::ios::binary};
+    file.read(reinterpret_cast<char *>(values.data()),
+              std::streamsize(size * sizeof(std::complex<double>)));
+    return values;
+}
+
+} // namespace
+
+class OutOfCore : public ::testing::TestWithParam<size_t> {};
+
+TEST_P(OutOfCore, MatchesInMemoryPlan) {
+    const size_t N = 12, M = 10;
+    auto input = temp_path("fftw-cpp-ooc-in.c128");
+    auto output = temp_path("fftw-cpp-ooc-out.c128");
+
+    fftw::mdbuffer<2> in{N, M}, expected{N, M};
+    for (size_t j = 0; j < N; ++j) {
+        for (size_t k = 0; k < M; ++k) {
+            in(j, k) = {std::cos(double(j * k) + 0.3 * double(j)), std::sin(double(j + 2 * k))};
+        }
+    }
+    write_complex(input, in);
+    fftw::plan<2u>::dft(in.to_mdspan(), expected.to_mdspan(), fftw::FORWARD, fftw::ESTIMATE)();
+
+    fftw::out_of_core_fft::options opts;
+    opts.slab_rows = GetParam();
+    fftw::out_of_core_fft engine{N, M, fftw::FORWARD, opts};
+    auto stats = engine.transform(input, output);
+
+    // both passes read and write the whole array
+    EXPECT_EQ(stats.bytes_read, 2 * N * M * sizeof(std::complex<double>));
+    EXPECT_EQ(stats.bytes_written, stats.bytes_read);
+    EXPECT_GE(stats.gb_per_second(), 0.0);
+
+    auto actual = read_complex(output, N * M);
+    EXPECT_THAT(actual, ElementsAreComplexNear(std::span(expected.data(), expected.size())));
+
+    std::filesystem::remove(input);
+    std::filesystem::remove(output);
+}
+
+// one row per slab, partial last slabs, and a single slab holding everything
+INSTANTIATE_TEST_SUITE_P(SlabRows, OutOfCore, ::testing::Values(1u, 3u, 5u, 64u));
+
+TEST(OutOfCoreOptions, SlabRowsFromBudget) {
+    fftw::out_of_core_fft::options opts;
+    opts.memory_budget = 4 * 100 * sizeof(std::complex<double>) * 7;
+    fftw::out_of_core_fft engine{50, 100, fftw::BACKWARD, opts};
+    EXPECT_EQ(engine.slab_rows().first, 7u);
+    EXPECT_EQ(engine.slab_rows().second, 14u);
+}
+
+TEST(OutOfCoreOptions, ConcurrentTransformsUseTheirOwnScratch) {
+    const size_t N = 16, M = 12;
+    auto run = [&](int id) {
+        auto input = temp_path(("fftw-cpp-ooc-concurrent-in-" + std::to_string(id)).c_str());
+        auto output = temp_path(("fftw-cpp-ooc-concurrent-out-" + std::to_string(id)).c_str());
+        fftw::mdbuffer<2> in{N, M}, expected{N, M};
+        for (size_t j = 0; j < N; ++j) {
+            for (size_t k = 0; k < M; ++k) {
+                in(j, k) = {double(id) + std::cos(double(j * k)), double(id * j) - double(k)};
+            }
+        }
+        write_complex(input, in);
+        fftw::plan<2u>::dft(in.to_mdspan(), expected.to_mdspan(), fftw::FORWARD, fftw::ESTIMATE)();
+
+        fftw::out_of_core_fft::options opts;
+        opts.slab_rows = 2;
+        // one engine per thread: transform() is not thread-safe
+        fftw::out_of_core_fft engine{N, M, fftw::FORWARD, opts};
+        for (int k = 0; k < 5; ++k) {
+            engine.transform(input, output);
+            EXPECT_THAT(read_complex(output, N * M),
+                        ElementsAreComplexNear(std::span(expected.data(), expected.size())));
+        }
+        std::filesystem::remove(input);
+        std::filesystem::remove(output);
+    };
+
+    auto other = std::async(std::launch::async, run, 1);
+    run(2);
+    other.get();
+}
@@ -0,0 +1,124 @@
+#include "fftw-cpp/fftw-cpp.h"
+#include "util.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <numbers>
+#include <thread>
+#include <vector>
+
+TEST(PlanCache, HitsAndMisses) {
+    fftw::plan_cache cache{4};
+    std::size_t N = 16;
+    fftw::buffer in(N), out(N), in2(N), out2(N);
+
+    auto p1 = cache.get<fftw::plan<>>(in, out, fftw::FORWARD, fftw::ESTIMATE);
+    auto p2 = cache.get<fftw::plan<>>(in2, out2, fftw::FORWARD, fftw::ESTIMATE);
+    EXPECT_EQ(p1, p2);
+
+    auto pInv = cache.get<fftw::plan<>>(in, out, fftw::BACKWARD, fftw::ESTIMATE);
+    EXPECT_NE(p1, pInv);
+
+    auto pInPlace = cache.get<fftw::plan<>>(in, in, fftw::FORWARD, fftw::ESTIMATE);
+    EXPECT_NE(p1, pInPlace);
+
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 3u);
+    EXPECT_EQ(stats.evictions, 0u);
+    EXPECT_EQ(stats.size, 3u);
+}
+
+TEST(PlanCache, ExecutesOnNewArrays) {
+    fftw::plan_cache cache;
+    int N = 8;
+    fftw::buffer in(N), out(N), out2(N);
+
+    auto p = cache.get<fftw::plan<>>(in, out, fftw::FORWARD, fftw::ESTIMATE);
+    auto pInv = cache.get<fftw::plan<>>(out, out2, fftw::BACKWARD, fftw::ESTIMATE);
+
+    fftw::buffer data(N), spectrum(N), result(N);
+    for (int j = 0; j < N; ++j) {
+        data[j] = {std::cos(2.0 * std::numbers::pi * j / N),
+                   std::cos(2.0 * std::numbers::pi * (j + double(N) / 2) / N)};
+    }
+
+    (*cache.get<fftw::plan<>>(data, spectrum, fftw::FORWARD, fftw::ESTIMATE))(data, spectrum);
+    (*pInv)(spectrum, result);
+
+    for (auto &elem : result) {
+        elem /= double(N);
+    }
+
+    EXPECT_THAT(result, ElementsAreComplexNear(data));
+    EXPECT_EQ(cache.stats().hits, 1u);
+}
+
+TEST(PlanCache, KeyedOnExtentsAndLayout) {
+    namespace stdex = std::experimental;
+    fftw::plan_cache cache;
+    fftw::rmdbuffer<2u> r1{4, 6}, r2{6, 4};
+    fftw::mdbuffer<2u> c1{4, 4}, c2{6, 3};
+
+    auto p1 = cache.get<fftw::plan_r2c<2u>>(r1.to_mdspan(), c1.to_mdspan(), fftw::ESTIMATE);
+    auto p2 = cache.get<fftw::plan_r2c<2u>>(r2.to_mdspan(), c2.to_mdspan(), fftw::ESTIMATE);
+    EXPECT_NE(p1, p2);
+
+    fftw::basic_rmdbuffer<double, fftw::dextents<size_t, 2u>, std::complex<double>,
+                          stdex::layout_left>
+        r3{6, 4};
+    fftw::basic_mdbuffer<double, fftw::dextents<size_t, 2u>, std::complex<double>,
+                         stdex::layout_left>
+        c3{4, 4};
+    auto p3 = cache.get<fftw::plan_r2c<2u>>(r3.to_mdspan(), c3.to_mdspan(), fftw::ESTIMATE);
+    EXPECT_NE(p1, p3);
+    EXPECT_EQ(cache.stats().misses, 3u);
+}
+
+TEST(PlanCache, EvictsLeastRecentlyUsed) {
+    fftw::plan_cache cache{2};
+    fftw::buffer a(8), b(16), c(32);
+
+    auto pa = cache.get<fftw::plan<>>(a, a, fftw::FORWARD, fftw::ESTIMATE);
+    cache.get<fftw::plan<>>(b, b, fftw::FORWARD, fftw::ESTIMATE);
+    cache.get<fftw::plan<>>(a, a, fftw::FORWARD, fftw::ESTIMATE); // a is now most recent
+    cache.get<fftw::plan<>>(c, c, fftw::FORWARD, fftw::ESTIMATE); // evicts b
+
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.evictions, 1u);
+    EXPECT_EQ(stats.size, 2u);
+
+    EXPECT_EQ(pa, cache.get<fftw::plan<>>(a, a, fftw::FORWARD, fftw::ESTIMATE));
+    cache.get<fftw::plan<>>(b, b, fftw::FORWARD, fftw::ESTIMATE);
+    EXPECT_EQ(cache.stats().misses, 4u);
+
+    cache.set_capacity(0);
+    EXPECT_EQ(cache.stats().size, 0u);
+    EXPECT_NE(pa, nullptr); // plans held by callers outlive eviction
+}
+
+TEST(PlanCache, ConcurrentLookups) {
+    fftw::plan_cache cache;
+    constexpr int threads = 8;
+    std::vector<std::shared_ptr<const fftw::plan<>>> plans(threads);
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            fftw::buffer in(64), out(64);
+            plans[t] = cache.get<fftw::plan<>>(in, out, fftw::FORWARD, fftw::ESTIMATE);
+            (*plans[t])(in, out);
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    for (auto &plan : plans) {
+        EXPECT_EQ(plan, plans[0]);
+    }
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.hits + stats.misses, std::size_t(threads));
+    EXPECT_EQ(stats.size, 1u);
+}
@@ -0,0 +1,93 @@
+#include "fftw-cpp/fftw-cpp.h"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <numbers>
+
+template <typename Real> class Precision : public ::testing::Test {
+  protected:
+    /// loose enough for the naive round-off of single precision, tight enough to catch a
+    /// transform that silently ran in another precision
+    static constexpr Real tolerance = std::numeric_limits<Real>::epsilon() * 1000;
+};
+
+using Precisions = ::testing::Types<double
+#ifdef FFTW_CPP_FLOAT
+                                    ,
+                                    float
+#endif
+#ifdef FFTW_CPP_LONG_DOUBLE
+                                    ,
+                                    long double
+#endif
+#ifdef FFTW_CPP_QUAD
+                                    ,
+                                    __float128
+#endif
+                                    >;
+TYPED_TEST_SUITE(Precision, Precisions);
+
+TYPED_TEST(Precision, TwoWay1d) {
+    using Real = TypeParam;
+    int N = 16;
+
+    fftw::basic_buffer<Real> in(N), out(N), out2(N);
+
+    auto p = fftw::basic_plan<1u, Real>::dft(in, out, fftw::FORWARD, fftw::ESTIMATE);
+    auto pInv = fftw::basic_plan<1u, Real>::dft(out, out2, fftw::BACKWARD, fftw::ESTIMATE);
+
+    for (int j = 0; j < N; ++j) {
+        in[j] = {Real(std::cos(2.0 * std::numbers::pi * j / N)), Real(j % 3)};
+    }
+
+    p();
+    pInv();
+
+    for (int j = 0; j < N; ++j) {
+        auto diff = out2[j] / Real(N) - in[j];
+        EXPECT_LT(Real(std::abs(diff)), this->tolerance) << "at index " << j;
+    }
+}
+
+TYPED_TEST(Precision, TwoWay2dR2C) {
+    using Real = TypeParam;
+    using d2 = fftw::dextents<std::size_t, 2u>;
+    std::size_t N = 4, M = 6;
+
+    fftw::basic_rmdbuffer<Real, d2> in{N, M}, out2{N, M};
+    fftw::basic_mdbuffer<Real, d2> out{N, M / 2 + 1};
+
+    auto p = fftw::basic_plan_r2c<2u, Real>::dft(in.to_mdspan(), out.to_mdspan(), fftw::ESTIMATE);
+    auto pInv =
+        fftw::basic_plan_c2r<2u, Real>::dft(out.to_mdspan(), out2.to_mdspan(), fftw::ESTIMATE);
+
+    for (std::size_t j = 0; j < N; ++j) {
+        for (std::size_t k = 0; k < M; ++k) {
+            in(j, k) = Real(std::sin(2.0 * std::numbers::pi * double(j + 2 * k) / double(N * M)));
+        }
+    }
+
+    p();
+    pInv();
+
+    for (std::size_t j = 0; j < N; ++j) {
+        for (std::size_t k = 0; k < M; ++k) {
+            auto diff = out2(j, k) / Real(N * M) - in(j, k);
+            EXPECT_LT(Real(diff < 0 ? -diff : diff), this->tolerance);
+        }
+    }
+}
+
+TYPED_TEST(Precision, BufferIsSimdAligned) {
+    using Real = TypeParam;
+    fftw::basic_buffer<Real> buf(7);
+    fftw::basic_rbuffer<Real> rbuf(7, Real(1));
+
+    EXPECT_EQ(fftw::detail::fftw_types<Real>::alignment_of(reinterpret_cast<Real *>(buf.data())),
+              0);
+    EXPECT_EQ(fftw::detail::fftw_types<Real>::alignment_of(rbuf.data()), 0);
+    for (auto elem : rbuf) {
+        EXPECT_EQ(elem, Real(1));
+    }
+}
@@ -32,6 +32,7 @@ int main() {
 
     auto p = fftw::plan_r2c<2u>::dft(in.to_mdspan(), out.to_mdspan(), fftw::Flags::ESTIMATE);
     auto pInv = fftw::plan_c2r<2u>::dft(out.to_mdspan(), out2.to_mdspan(), fftw::Flags::ESTIMATE);
+    pInv.normalize(fftw::normalization::BACKWARD);
 
     for (int j = 0; j < in.extent(0); ++j) {
         for (int k = 0; k < in.extent(1); ++k) {
@@ -47,12 +48,4 @@ int main() {
 
     pInv();
     print(out2);
-
-    for (int j = 0; j < out2.extent(0); ++j) {
-        for (int k = 0; k < out2.extent(1); ++k) {
-            std::cout << out2(j, k) / double(out2.size()) << " ";
-        }
-        std::cout << std::endl;
-    }
-    std::cout << std::endl;
 }
\ No newline at end of file
@@ -0,0 +1,206 @@
+#include "fftw-cpp/fftw-cpp.h"
+#include "util.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <numbers>
+#include <vector>
+
+using fftw::R2RKind;
+
+namespace {
+
+/// Naive 1D r2r transforms, straight from the definitions in the FFTW manual.
+std::vector<double> naive_r2r(const std::vector<double> &x, R2RKind kind) {
+    constexpr double pi = std::numbers::pi;
+    auto n = std::ptrdiff_t(x.size());
+    std::vector<double> y(x.size());
+
+    for (std::ptrdiff_t k = 0; k < n; ++k) {
+        double sign_k = (k % 2) ? -1.0 : 1.0;
+        double acc = 0.0;
+        switch (kind) {
+        case R2RKind::R2HC:
+        case R2RKind::HC2R:
+            ADD_FAILURE() << "halfcomplex kinds are checked against the complex DFT";
+            break;
+        case R2RKind::DHT:
+            for (std::ptrdiff_t j = 0; j < n; ++j) {
+                acc += x[j] * (std::cos(2 * pi * j * k / n) + std::sin(2 * pi * j * k / n));
+            }
+            break;
+        case R2RKind::REDFT00:
+            acc = x[0] + sign_k * x[n - 1];
+            for (std::ptrdiff_t j = 1; j < n - 1; ++j) {
+                acc += 2 * x[j] * std::cos(pi * j * k / double(n - 1));
+            }
+            break;
+        case R2RKind::REDFT10:
+            for (std::ptrdiff_t j = 0; j < n; ++j) {
+                acc += 2 * x[j] * std::cos(pi * (j + 0.5) * k / n);
+            }
+            break;
+        case R2RKind::REDFT01:
+            acc = x[0];
+            for (std::ptrdiff_t j = 1; j < n; ++j) {
+                acc += 2 * x[j] * std::cos(pi * j * (k + 0.5) / n);
+            }
+            break;
+        case R2RKind::REDFT11:
+            for (std::ptrdiff_t j = 0; j < n; ++j) {
+                acc += 2 * x[j] * std::cos(pi * (j + 0.5) * (k + 0.5) / n);
+            }
+            break;
+        case R2RKind::RODFT00:
+            for (std::ptrdiff_t j = 0; j < n; ++j) {
+                acc += 2 * x[j] * std::sin(pi * (j + 1) * (k + 1) / double(n + 1));
+            }
+            break;
+        case R2RKind::RODFT10:
+            for (std::ptrdiff_t j = 0; j < n; ++j) {
+                acc += 2 * x[j] * std::sin(pi * (j + 0.5) * (k + 1) / n);
+            }
+            break;
+        case R2RKind::RODFT01:
+            acc = sign_k * x[n - 1];
+            for (std::ptrdiff_t j = 0; j < n - 1; ++j) {
+                acc += 2 * x[j] * std::sin(pi * (j + 1) * (k + 0.5) / n);
+            }
+            break;
+        case R2RKind::RODFT11:
+            for (std::ptrdiff_t j = 0; j < n; ++j) {
+                acc += 2 * x[j] * std::sin(pi * (j + 0.5) * (k + 0.5) / n);
+            }
+            break;
+        }
+        y[k] = acc;
+    }
+    return y;
+}
+
+std::vector<double> sample(std::size_t n, double offset = 0.0) {
+    std::vector<double> x(n);
+    for (std::size_t j = 0; j < n; ++j) {
+        x[j] = std::cos(double(j * j) / 5.0 + offset) + 0.25 * double(j % 3);
+    }
+    return x;
+}
+
+} // namespace
+
+class R2R1d : public ::testing::TestWithParam<R2RKind> {};
+
+TEST_P(R2R1d, MatchesNaive) {
+    std::size_t N = 9;
+    fftw::rbuffer in(N), out(N);
+    auto x = sample(N);
+    std::ranges::copy(x, in.begin());
+
+    auto p = fftw::plan_r2r<1u>::dft(in, out, GetParam(), fftw::ESTIMATE);
+    p();
+
+    auto expected = naive_r2r(x, GetParam());
+    for (std::size_t k = 0; k < N; ++k) {
+        EXPECT_NEAR(out[k], expected[k], TOLERANCE) << "at index " << k;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(AllKinds, R2R1d,
+                         ::testing::Values(R2RKind::DHT, R2RKind::REDFT00, R2RKind::REDFT01,
+                                           R2RKind::REDFT10, R2RKind::REDFT11, R2RKind::RODFT00,
+                                           R2RKind::RODFT01, R2RKind::RODFT10, R2RKind::RODFT11));
+
+TEST(R2R, HalfcomplexMatchesComplexDft) {
+    std::size_t N = 8;
+    fftw::rbuffer in(N), hc(N), back(N);
+    fftw::buffer c_in(N), c_out(N);
+    auto x = sample(N);
+    std::ranges::copy(x, in.begin());
+    std::ranges::copy(x, c_in.begin());
+
+    fftw::plan_r2r<1u>::dft(in, hc, R2RKind::R2HC, fftw::ESTIMATE)();
+    fftw::plan<1u>::dft(c_in, c_out, fftw::FORWARD, fftw::ESTIMATE)();
+
+    // r0, r1, ..., r(n/2), i((n+1)/2 - 1), ..., i1
+    for (std::size_t k = 0; k <= N / 2; ++k) {
+        EXPECT_NEAR(hc[k], c_out[k].real(), TOLERANCE);
+    }
+    for (std::size_t k = 1; k < (N + 1) / 2; ++k) {
+        EXPECT_NEAR(hc[N - k], c_out[k].imag(), TOLERANCE);
+    }
+
+    fftw::plan_r2r<1u>::dft(hc, back, R2RKind::HC2R, fftw::ESTIMATE)();
+    for (std::size_t j = 0; j < N; ++j) {
+        EXPECT_NEAR(back[j] / double(N), x[j], TOLERANCE);
+    }
+}
+
+TEST(R2R, DctRoundTripAndNewArrayExecution) {
+    std::size_t N = 16;
+    fftw::rbuffer in(N), coeffs(N), back(N), in2(N), coeffs2(N);
+    auto x = sample(N), x2 = sample(N, 1.0);
+    std::ranges::copy(x, in.begin());
+    std::ranges::copy(x2, in2.begin());
+
+    auto dct2 = fftw::plan_r2r<1u>::dft(in, coeffs, R2RKind::REDFT10, fftw::ESTIMATE);
+    auto dct3 = fftw::plan_r2r<1u>::dft(coeffs, back, R2RKind::REDFT01, fftw::ESTIMATE);
+    dct2();
+    dct3();
+
+    auto scale = double(fftw::logical_size(R2RKind::REDFT10, std::ptrdiff_t(N)));
+    for (std::size_t j = 0; j < N; ++j) {
+        EXPECT_NEAR(back[j] / scale, x[j], TOLERANCE);
+    }
+
+    dct2(in2, coeffs2);
+    auto expected = naive_r2r(x2, R2RKind::REDFT10);
+    for (std::size_t k = 0; k < N; ++k) {
+        EXPECT_NEAR(coeffs2[k], expected[k], TOLERANCE);
+    }
+}
+
+TEST(R2R, TwoDimensionalMixedKinds) {
+    std::size_t N = 4, M = 5;
+    fftw::rmdbuffer<2u> in{N, M}, out{N, M};
+    fftw::rmdbuffer<2u, fftw::layout_left> in_l{N, M}, out_l{N, M};
+    for (std::size_t j = 0; j < N; ++j) {
+        auto row = sample(M, double(j));
+        for (std::size_t k = 0; k < M; ++k) {
+            in(j, k) = in_l(j, k) = row[k];
+        }
+    }
+
+    // DCT-II along the first index, DST-II along the second
+    fftw::plan_r2r<2u>::kinds_t kinds{R2RKind::REDFT10, R2RKind::RODFT10};
+    fftw::plan_r2r<2u>::dft(in.to_mdspan(), out.to_mdspan(), kinds, fftw::ESTIMATE)();
+    fftw::plan_r2r<2u>::dft(in_l, out_l, kinds, fftw::ESTIMATE)();
+
+    // separable reference: rows first, then columns
+    std::vector<std::vector<double>> rows(N);
+    for (std::size_t j = 0; j < N; ++j) {
+        std::vector<double> row(M);
+        for (std::size_t k = 0; k < M; ++k) {
+            row[k] = in(j, k);
+        }
+        rows[j] = naive_r2r(row, R2RKind::RODFT10);
+    }
+    for (std::size_t k = 0; k < M; ++k) {
+        std::vector<double> col(N);
+        for (std::size_t j = 0; j < N; ++j) {
+            col[j] = rows[j][k];
+        }
+        auto expected = naive_r2r(col, R2RKind::REDFT10);
+        for (std::size_t j = 0; j < N; ++j) {
+            EXPECT_NEAR(out(j, k), expected[j], TOLERANCE);
+            EXPECT_NEAR(out_l(j, k), expected[j], TOLERANCE);
+        }
+    }
+}
+
+TEST(R2R, Validates) {
+    fftw::rbuffer a(4), b(5), one(1), one2(1);
+    EXPECT_THROW(fftw::plan_r2r<1u>::dft(a, b, R2RKind::REDFT10, fftw::ESTIMATE),
+                 std::invalid_argument);
+    EXPECT_THROW(fftw::plan_r2r<1u>::dft(one, one2, R2RKind::REDFT00, fftw::ESTIMATE),
+                 std::invalid_argument);
+}
@@ -0,0 +1,128 @@
+#include "fftw-cpp/fftw-cpp.h"
+#include "util.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace stdex = std::experimental;
+
+namespace {
+
+std::vector<double> make_signal(size_t length, double frequency) {
+    std::vector<double> x(length);
+    for (size_t i = 0; i < length; ++i) {
+        x[i] = std::sin(frequency * double(i)) + 0.1 * double(i % 5);
+    }
+    return x;
+}
+
+/// The spectrum of a real signal, as a filter for the pipeline.
+fftw::buffer half_spectrum(std::vector<double> x) {
+    fftw::buffer spectrum(x.size() / 2 + 1);
+    stdex::mdspan<double, stdex::dextents<size_t, 1>> in{x.data(), x.size()};
+    stdex::mdspan<std::complex<double>, stdex::dextents<size_t, 1>> out{spectrum.data(),
+                                                                       spectrum.size()};
+    fftw::plan_r2c<1u>::dft(in, out, fftw::ESTIMATE)();
+    return spectrum;
+}
+
+void expect_near(std::span<const double> actual, const std::vector<double> &expected) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        EXPECT_NEAR(actual[i], expected[i], 1e-8) << i;
+    }
+}
+
+} // namespace
+
+TEST(SpectralPipeline, MultiplyIsCircularConvolution) {
+    // more than one block of the spectrum
+    const size_t N = 2100;
+    auto x = make_signal(N, 0.01), h = make_signal(N, 0.3);
+    auto filter = half_spectrum(h);
+
+    fftw::spectral_pipeline<1> convolve{{N}, fftw::ESTIMATE};
+    ASSERT_GT(convolve.spectrum_size(), convolve.block_size);
+    convolve.multiply(filter);
+
+    std::vector<double> y(N);
+    using view = fftw::spectral_pipeline<1>::real_view;
+    convolve(view{x.data(), N}, view{y.data(), N});
+
+    std::vector<double> expected(N, 0.0);
+    for (size_t i = 0; i < N; ++i) {
+        for (size_t k = 0; k < N; ++k) {
+            expected[i] += x[(i + N - k) % N] * h[k];
+        }
+    }
+    expect_near(y, expected);
+}
+
+TEST(SpectralPipeline, ConjMultiplyIsCircularCorrelation) {
+    const size_t N = 50;
+    auto x = make_signal(N, 0.2), h = make_signal(N, 0.7);
+    auto filter = half_spectrum(h);
+
+    fftw::spectral_pipeline<1> correlate{{N}, fftw::ESTIMATE};
+    correlate.conj_multiply(filter);
+    auto signal = correlate.signal();
+    std::copy(x.begin(), x.end(), signal.data_handle());
+    correlate();
+
+    std::vector<double> expected(N, 0.0);
+    for (size_t k = 0; k < N; ++k) {
+        for (size_t j = 0; j < N; ++j) {
+            expected[k] += x[(j + k) % N] * h[j];
+        }
+    }
+    expect_near({signal.data_handle(), N}, expected);
+}
+
+TEST(SpectralPipeline, StagesRunInOrder) {
+    const size_t N = 6, M = 8;
+    fftw::rmdbuffer<2> image{N, M}, result{N, M};
+    for (size_t i = 0; i < N; ++i) {
+        for (size_t j = 0; j < M; ++j) {
+            image(i, j) = double(i * j % 7) - 1.5;
+        }
+    }
+    double mean = std::accumulate(image.data(), image.data() + image.size(), 0.0) / double(N * M);
+
+    fftw::spectral_pipeline<2> pipeline{{N, M}, fftw::ESTIMATE};
+    EXPECT_EQ(pipeline.spectrum_extents().extent(1), M / 2 + 1);
+    fftw::buffer twos(pipeline.spectrum_size());
+    std::fill(twos.begin(), twos.end(), std::complex<double>{2.0});
+
+    // keeps only the DC component, then doubles it
+    pipeline.apply([](std::complex<double> x, size_t i) { return i == 0 ? x : 0.0; })
+        .multiply(twos);
+    pipeline(image, result);
+    for (size_t i = 0; i < result.size(); ++i) {
+        EXPECT_NEAR(result.data()[i], 2.0 * mean, TOLERANCE);
+    }
+
+    // without stages, the pipeline reproduces its input, also in place
+    pipeline.clear_stages();
+    pipeline(image, image);
+    for (size_t i = 0; i < N; ++i) {
+        for (size_t j = 0; j < M; ++j) {
+            EXPECT_NEAR(image(i, j), double(i * j % 7) - 1.5, TOLERANCE);
+        }
+    }
+}
+
+TEST(SpectralPipeline, Validates) {
+    EXPECT_THROW((fftw::spectral_pipeline<2>{{4, 0}, fftw::ESTIMATE}), std::invalid_argument);
+
+    fftw::spectral_pipeline<1> pipeline{{16}, fftw::ESTIMATE};
+    fftw::buffer wrong(16);
+    EXPECT_THROW(pipeline.multiply(wrong), std::invalid_argument);
+    EXPECT_THROW(pipeline.add_stage({}), std::invalid_argument);
+
+    std::vector<double> short_signal(8);
+    fftw::spectral_pipeline<1>::real_view short_view{short_signal.data(), 8};
+    EXPECT_THROW(pipeline(short_view, pipeline.signal()), std::invalid_argument);
+}
@@ -0,0 +1,113 @@
+#include "fftw-cpp/fftw-cpp.h"
+#include "util.hpp"
+
+#include <array>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <type_traits>
+
+namespace stdex = std::experimental;
+
+namespace {
+
+template <size_t N>
+using static_view = stdex::mdspan<std::complex<double>, stdex::extents<size_t, N>>;
+using dynamic_view = stdex::mdspan<std::complex<double>, stdex::dextents<size_t, 1>>;
+
+template <size_t N> std::array<std::complex<double>, N> make_input() {
+    std::array<std::complex<double>, N> x;
+    for (size_t i = 0; i < N; ++i) {
+        x[i] = {std::cos(double(i * i) / 5.0), std::sin(double(i) / 3.0) - 0.25};
+    }
+    return x;
+}
+
+static_assert(std::is_same_v<fftw::static_dft_plan<static_view<16>>, fftw::static_plan<16>>);
+static_assert(std::is_same_v<fftw::static_dft_plan<static_view<12>>, fftw::plan<1u>>);
+static_assert(std::is_same_v<fftw::static_dft_plan<static_view<128>>, fftw::plan<1u>>);
+static_assert(std::is_same_v<fftw::static_dft_plan<dynamic_view>, fftw::plan<1u>>);
+
+} // namespace
+
+template <typename T> class StaticPlan : public ::testing::Test {};
+using StaticSizes = ::testing::Types<std::integral_constant<size_t, 2>,
+                                     std::integral_constant<size_t, 4>,
+                                     std::integral_constant<size_t, 8>,
+                                     std::integral_constant<size_t, 16>,
+                                     std::integral_constant<size_t, 32>,
+                                     std::integral_constant<size_t, 64>>;
+TYPED_TEST_SUITE(StaticPlan, StaticSizes);
+
+TYPED_TEST(StaticPlan, MatchesFFTW) {
+    constexpr size_t N = TypeParam::value;
+    for (auto direction : {fftw::FORWARD, fftw::BACKWARD}) {
+        auto in = make_input<N>();
+        std::array<std::complex<double>, N> out{}, expected{};
+
+        auto p = fftw::static_plan<N>::dft(static_view<N>{in.data()}, static_view<N>{out.data()},
+                                            direction);
+        p();
+        fftw::plan<1u>::dft(dynamic_view{in.data(), N}, dynamic_view{expected.data(), N}, direction,
+                            fftw::ESTIMATE)();
+        EXPECT_THAT(out, ElementsAreComplexNear(expected));
+    }
+}
+
+TYPED_TEST(StaticPlan, NewArraysInPlaceAndStrided) {
+    constexpr size_t N = TypeParam::value;
+    auto in = make_input<N>();
+    std::array<std::complex<double>, N> planned{}, expected{};
+    auto p = fftw::static_plan<N>::dft(static_view<N>{planned.data()},
+                                        static_view<N>{planned.data()}, fftw::FORWARD);
+    fftw::plan<1u>::dft(dynamic_view{in.data(), N}, dynamic_view{expected.data(), N},
+                        fftw::FORWARD, fftw::ESTIMATE)();
+
+    // in place
+    auto data = in;
+    p(static_view<N>{data.data()}, static_view<N>{data.data()});
+    EXPECT_THAT(data, ElementsAreComplexNear(expected));
+
+    // every other element of a larger array
+    using strided = stdex::mdspan<std::complex<double>, stdex::extents<size_t, N>,
+                                  stdex::layout_stride>;
+    std::array<std::complex<double>, 2 * N> interleaved{};
+    for (size_t i = 0; i < N; ++i) {
+        interleaved[2 * i] = in[i];
+    }
+    strided view{interleaved.data(),
+                 stdex::layout_stride::mapping<stdex::extents<size_t, N>>{
+                     stdex::extents<size_t, N>{}, std::array<size_t, 1>{2}}};
+    p(view, view);
+    for (size_t i = 0; i < N; ++i) {
+        EXPECT_THAT(view(i), IsComplexNear(expected[i]));
+        EXPECT_EQ(interleaved[2 * i + 1], std::complex<double>{});
+    }
+}
+
+TEST(StaticPlan, NormalizedRoundTrip) {
+    auto in = make_input<32>();
+    std::array<std::complex<double>, 32> spectrum{}, back{};
+    auto forward = fftw::static_plan<32>::dft(static_view<32>{in.data()},
+                                              static_view<32>{spectrum.data()}, fftw::FORWARD);
+    auto backward = fftw::static_plan<32>::dft(static_view<32>{spectrum.data()},
+                                               static_view<32>{back.data()}, fftw::BACKWARD);
+    backward.normalize(fftw::normalization::BACKWARD);
+    EXPECT_DOUBLE_EQ(backward.scale_factor(), 1.0 / 32.0);
+    forward();
+    backward();
+    EXPECT_THAT(back, ElementsAreComplexNear(in));
+
+    fftw::static_plan<32> empty;
+    EXPECT_THROW(empty(), std::logic_error);
+}
+
+TEST(StaticPlan, LargeStaticSizesUseFFTW) {
+    auto in = make_input<100>();
+    std::array<std::complex<double>, 100> out{}, expected{};
+    auto p = fftw::static_dft_plan<static_view<100>>::dft(
+        static_view<100>{in.data()}, static_view<100>{out.data()}, fftw::FORWARD, fftw::ESTIMATE);
+    p();
+    fftw::plan<1u>::dft(dynamic_view{in.data(), 100}, dynamic_view{expected.data(), 100},
+                        fftw::FORWARD, fftw::ESTIMATE)();
+    EXPECT_THAT(out, ElementsAreComplexNear(expected));
+}
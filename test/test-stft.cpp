@@ -0,0 +1,109 @@
+#include "fftw-cpp/fftw-cpp.h"
+#include "util.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <numbers>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+std::vector<double> hamming(size_t size) {
+    std::vector<double> w(size);
+    for (size_t i = 0; i < size; ++i) {
+        w[i] = 0.54 - 0.46 * std::cos(2.0 * std::numbers::pi * double(i) / double(size));
+    }
+    return w;
+}
+
+std::vector<double> make_signal(size_t length) {
+    std::vector<double> x(length);
+    for (size_t i = 0; i < length; ++i) {
+        x[i] = std::sin(0.3 * double(i)) + 0.5 * std::cos(0.05 * double(i * i % 97));
+    }
+    return x;
+}
+
+} // namespace
+
+TEST(Stft, ForwardMatchesWindowedDft) {
+    const size_t W = 16, hop = 5, N = 20;
+    auto window = hamming(W);
+    auto signal = make_signal(83);
+
+    // 3 frames per batch leaves a partial batch at the end
+    fftw::stft analysis{window, hop, N, 3, fftw::ESTIMATE};
+    auto frames = analysis.frames(signal.size());
+    ASSERT_EQ(frames, 14u);
+    ASSERT_EQ(analysis.bins(), N / 2 + 1);
+
+    fftw::mdbuffer<2> spectrogram{frames, analysis.bins()};
+    analysis.forward(signal, spectrogram);
+
+    for (size_t f = 0; f < frames; ++f) {
+        for (size_t k = 0; k < analysis.bins(); ++k) {
+            std::complex<double> expected{};
+            for (size_t i = 0; i < W; ++i) {
+                expected += signal[f * hop + i] * window[i] *
+                            std::polar(1.0, -2.0 * std::numbers::pi * double(i * k) / double(N));
+            }
+            EXPECT_THAT(spectrogram(f, k), IsComplexNear(expected)) << f << ", " << k;
+        }
+    }
+}
+
+TEST(Stft, InverseReconstructsSignal) {
+    const size_t W = 32, hop = 8;
+    auto window = hamming(W);
+    auto signal = make_signal(W + 20 * hop);
+
+    for (size_t fft_size : {W, 2 * W}) {
+        fftw::stft stft{window, hop, fft_size, 4, fftw::ESTIMATE};
+        auto frames = stft.frames(signal.size());
+        fftw::mdbuffer<2> spectrogram{frames, stft.bins()};
+        stft.forward(signal, spectrogram);
+
+        std::vector<double> reconstructed(stft.signal_length(frames));
+        ASSERT_EQ(reconstructed.size(), signal.size());
+        stft.inverse(spectrogram, reconstructed);
+
+        for (size_t t = 0; t < signal.size(); ++t) {
+            EXPECT_NEAR(reconstructed[t], signal[t], TOLERANCE) << fft_size << ", " << t;
+        }
+    }
+}
+
+TEST(Stft, InversePreservesSpectrogram) {
+    auto window = hamming(8);
+    auto signal = make_signal(40);
+
+    fftw::stft stft{window, 2, 0, 4, fftw::ESTIMATE};
+    fftw::mdbuffer<2> spectrogram{stft.frames(signal.size()), stft.bins()};
+    stft.forward(signal, spectrogram);
+    std::vector<std::complex<double>> before(spectrogram.data(),
+                                             spectrogram.data() + spectrogram.size());
+
+    std::vector<double> reconstructed(signal.size());
+    stft.inverse(spectrogram, reconstructed);
+    EXPECT_THAT(std::span(spectrogram.data(), spectrogram.size()), ElementsAreComplexNear(before));
+}
+
+TEST(Stft, Validates) {
+    auto window = hamming(8);
+    std::vector<double> empty, signal(64);
+
+    EXPECT_THROW((fftw::stft{empty, 2}), std::invalid_argument);
+    EXPECT_THROW((fftw::stft{window, 0}), std::invalid_argument);
+    EXPECT_THROW((fftw::stft{window, 2, 4}), std::invalid_argument);
+
+    fftw::stft stft{window, 4, 0, 4, fftw::ESTIMATE};
+    fftw::mdbuffer<2> too_few_rows{stft.frames(signal.size()) - 1, stft.bins()};
+    fftw::mdbuffer<2> wrong_bins{stft.frames(signal.size()), stft.bins() + 1};
+    EXPECT_THROW(stft.forward(signal, too_few_rows), std::invalid_argument);
+    EXPECT_THROW(stft.forward(signal, wrong_bins), std::invalid_argument);
+
+    fftw::mdbuffer<2> spectrogram{4, stft.bins()};
+    std::vector<double> too_short(stft.signal_length(4) - 1);
+    EXPECT_THROW(stft.inverse(spectrogram, too_short), std::invalid_argument);
+}
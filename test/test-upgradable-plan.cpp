@@ -0,0 +1,173 @@
+#include "fftw-cpp/fftw-cpp.h"
+#include "util.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void fill(fftw::mdbuffer<2> &buf) {
+    for (size_t i = 0; i < buf.extent(0); ++i) {
+        for (size_t j = 0; j < buf.extent(1); ++j) {
+            buf(i, j) = {std::cos(double(3 * i + j)), std::sin(double(i * j))};
+        }
+    }
+}
+
+/// A plan whose MEASURE/PATIENT planning holds the planner lock until released, like a long
+/// planner run.
+class held_plan : public fftw::plan<1u> {
+  public:
+    static inline std::atomic<bool> holding{false};
+    static inline std::shared_future<void> release;
+
+    explicit held_plan(fftw::plan<1u> plan) : fftw::plan<1u>(std::move(plan)) {}
+
+    template <typename In, typename Out>
+    static held_plan dft(In &&in, Out &&out, fftw::Direction direction, fftw::Flags flags,
+                         int threads) {
+        if ((unsigned(flags) & FFTW_ESTIMATE) == 0) {
+            std::lock_guard lock{fftw::detail::planner_mutex()};
+            holding = true;
+            release.wait();
+        }
+        return held_plan{fftw::plan<1u>::dft(in, out, direction, flags, threads)};
+    }
+};
+
+} // namespace
+
+TEST(UpgradablePlan, ServesEstimateThenUpgrades) {
+    const size_t N = 12, M = 10;
+    fftw::mdbuffer<2> in{N, M}, out{N, M}, expected{N, M};
+    fill(in);
+    fftw::plan<2u>::dft(in.to_mdspan(), expected.to_mdspan(), fftw::FORWARD, fftw::ESTIMATE)();
+    std::vector<std::complex<double>> original(in.data(), in.data() + in.size());
+
+    fftw::upgradable_plan<fftw::plan<2u>> p{{fftw::MEASURE, 1.0}, in.to_mdspan(),
+                                            out.to_mdspan(), fftw::FORWARD};
+    p();
+    std::span actual{out.data(), out.size()};
+    std::span expected_span{expected.data(), expected.size()};
+    EXPECT_THAT(actual, ElementsAreComplexNear(expected_span));
+
+    p.wait();
+    EXPECT_TRUE(p.upgraded());
+    EXPECT_NE(p.current(), nullptr);
+
+    // the planner worked on scratch arrays, the caller's input is intact
+    EXPECT_THAT(std::span(in.data(), in.size()), ElementsAreComplexNear(original));
+
+    std::fill(out.data(), out.data() + out.size(), std::complex<double>{});
+    p();
+    EXPECT_THAT(actual, ElementsAreComplexNear(expected_span));
+
+    fftw::mdbuffer<2> out2{N, M};
+    p(in.to_mdspan(), out2.to_mdspan());
+    EXPECT_THAT(std::span(out2.data(), out2.size()), ElementsAreComplexNear(expected_span));
+}
+
+TEST(UpgradablePlan, InPlaceBuffers) {
+    const size_t N = 24;
+    fftw::buffer data(N), expected(N);
+    for (size_t i = 0; i < N; ++i) {
+        data[i] = {double(i % 5), -double(i % 3)};
+    }
+    fftw::plan<1u>::dft(data, expected, fftw::BACKWARD, fftw::ESTIMATE)();
+
+    fftw::upgradable_plan<fftw::plan<1u>> p{{fftw::PATIENT}, data, data, fftw::BACKWARD};
+    p.wait();
+    p();
+    EXPECT_THAT(data, ElementsAreComplexNear(expected));
+}
+
+TEST(UpgradablePlan, ExecutionsDuringUpgrade) {
+    const size_t N = 16, M = 16;
+    fftw::mdbuffer<2> in{N, M}, expected{N, M};
+    fill(in);
+    fftw::plan<2u>::dft(in.to_mdspan(), expected.to_mdspan(), fftw::FORWARD, fftw::ESTIMATE)();
+
+    fftw::mdbuffer<2> scratch{N, M};
+    fftw::upgradable_plan<fftw::plan<2u>> p{{fftw::MEASURE}, in.to_mdspan(), scratch.to_mdspan(),
+                                            fftw::FORWARD};
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 3; ++t) {
+        workers.emplace_back([&] {
+            fftw::mdbuffer<2> out{N, M};
+            for (int k = 0; k < 20; ++k) {
+                p(in.to_mdspan(), out.to_mdspan());
+                for (size_t i = 0; i < out.size(); ++i) {
+                    if (std::abs(out.data()[i] - expected.data()[i]) > TOLERANCE) { ++mismatches; }
+                }
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+    p.wait();
+    EXPECT_EQ(mismatches.load(), 0);
+}
+
+TEST(UpgradablePlan, MisalignedExecutionDuringUpgrade) {
+    const size_t N = 16;
+    fftw::buffer in(N), out(N), expected(N);
+    for (size_t i = 0; i < N; ++i) {
+        in[i] = {std::cos(double(i)), double(i % 3)};
+    }
+    fftw::plan<1u>::dft(in, expected, fftw::FORWARD, fftw::ESTIMATE)();
+
+    // One real past an aligned allocation is in another alignment class.
+    fftw::rbuffer storage(4 * N + 1);
+    auto *shifted = reinterpret_cast<std::complex<double> *>(storage.data() + 1);
+    fftw::buffer_view shifted_in{shifted, N}, shifted_out{shifted + N, N};
+    std::copy(in.begin(), in.end(), shifted_in.begin());
+
+    std::promise<void> release;
+    held_plan::holding = false;
+    held_plan::release = release.get_future().share();
+    fftw::upgradable_plan<held_plan> p{{fftw::MEASURE}, in, out, fftw::FORWARD};
+    while (!held_plan::holding) {
+        std::this_thread::yield();
+    }
+
+    auto call = std::async(std::launch::async, [&] { p(shifted_in, shifted_out); });
+    auto status = call.wait_for(std::chrono::seconds(10));
+    EXPECT_FALSE(p.upgraded());
+    release.set_value();
+    call.get();
+    p.wait();
+
+    EXPECT_EQ(status, std::future_status::ready);
+    EXPECT_THAT(shifted_out, ElementsAreComplexNear(expected));
+}
+
+TEST(UpgradablePlan, FailedUpgradeKeepsEstimate) {
+    fftw::wisdom::forget();
+    fftw::buffer in(37), out(37);
+    fftw::upgradable_plan<fftw::plan<1u>> p{{fftw::MEASURE | fftw::WISDOM_ONLY}, in, out,
+                                            fftw::FORWARD};
+    EXPECT_THROW(p.wait(), std::runtime_error);
+    EXPECT_FALSE(p.upgraded());
+    std::fill(in.begin(), in.end(), std::complex<double>{});
+    in[0] = 1.0;
+    p();
+    EXPECT_THAT(out, ElementsAreComplexNear(std::vector<std::complex<double>>(37, 1.0)));
+}
+
+TEST(PlannerTimeLimit, ScopedPerThread) {
+    EXPECT_THROW(fftw::planner_time_limit{-2.0}, std::invalid_argument);
+    {
+        fftw::planner_time_limit limit{0.5};
+        EXPECT_EQ(fftw::detail::plan_time_limit(), 0.5);
+        std::thread([] { EXPECT_EQ(fftw::detail::plan_time_limit(), FFTW_NO_TIMELIMIT); }).join();
+    }
+    EXPECT_EQ(fftw::detail::plan_time_limit(), FFTW_NO_TIMELIMIT);
+}
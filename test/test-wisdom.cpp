@@ -0,0 +1,123 @@
+#include "fftw-cpp/fftw-cpp.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+namespace {
+std::filesystem::path temp_wisdom_path(const char *name) {
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove(path);
+    return path;
+}
+
+/// Planning with WISDOM_ONLY only succeeds if MEASURE wisdom exists for the transform.
+bool has_wisdom_for(int n) {
+    fftw::buffer in(n), out(n);
+    auto *p = fftw_plan_dft_1d(n, in.unwrap(), out.unwrap(), FFTW_FORWARD,
+                               FFTW_MEASURE | FFTW_WISDOM_ONLY);
+    if (p == nullptr) { return false; }
+    fftw_destroy_plan(p);
+    return true;
+}
+} // namespace
+
+TEST(Wisdom, StringRoundTrip) {
+    fftw::wisdom::forget();
+    fftw::warm_up({{fftw::transform_kind::C2C, {32}, fftw::FORWARD}}, fftw::MEASURE);
+
+    auto exported = fftw::wisdom::export_to_string();
+    EXPECT_FALSE(exported.empty());
+
+    fftw::wisdom::forget();
+    EXPECT_FALSE(has_wisdom_for(32));
+
+    EXPECT_TRUE(fftw::wisdom::import_from_string(exported));
+    EXPECT_TRUE(has_wisdom_for(32));
+
+    EXPECT_FALSE(fftw::wisdom::import_from_string("not wisdom"));
+}
+
+TEST(Wisdom, FileExportedOnDestruction) {
+    auto path = temp_wisdom_path("fftw-cpp-test.wisdom");
+    fftw::wisdom::forget();
+
+    {
+        fftw::wisdom_file wisdom{path, {.system_fallback = false}};
+        EXPECT_FALSE(wisdom.loaded_from_file());
+        EXPECT_FALSE(wisdom.loaded_from_system());
+
+        fftw::buffer in(64), out(64);
+        fftw::plan<>::dft(in, out, fftw::FORWARD, fftw::MEASURE);
+    }
+    ASSERT_TRUE(std::filesystem::exists(path));
+
+    fftw::wisdom::forget();
+    EXPECT_FALSE(has_wisdom_for(64));
+    {
+        fftw::wisdom_file wisdom{path, {.system_fallback = false, .export_on_exit = false}};
+        EXPECT_TRUE(wisdom.loaded_from_file());
+        EXPECT_TRUE(has_wisdom_for(64));
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(Wisdom, InvalidFileIsNotLoaded) {
+    auto path = temp_wisdom_path("fftw-cpp-invalid.wisdom");
+    std::ofstream{path} << "garbage";
+
+    fftw::wisdom_file wisdom{path, {.system_fallback = false, .export_on_exit = false}};
+    EXPECT_FALSE(wisdom.loaded_from_file());
+
+    std::filesystem::remove(path);
+}
+
+TEST(Wisdom, WarmUpAllKinds) {
+    fftw::wisdom::forget();
+    fftw::warm_up(
+        {
+            {fftw::transform_kind::C2C, {8, 12}, fftw::BACKWARD},
+            {fftw::transform_kind::R2C, {16, 10}},
+            {fftw::transform_kind::C2R, {16, 10}},
+            {fftw::transform_kind::R2C, {32}, fftw::FORWARD, true},
+        },
+        fftw::MEASURE);
+
+    // everything is in the wisdom now, so WISDOM_ONLY planning succeeds
+    fftw::rmdbuffer<2u> r{16, 10};
+    fftw::mdbuffer<2u> c{16, 6};
+    auto *p = fftw_plan_dft_r2c_2d(16, 10, reinterpret_cast<double *>(r.data()),
+                                   reinterpret_cast<fftw_complex *>(c.data()),
+                                   FFTW_MEASURE | FFTW_WISDOM_ONLY);
+    EXPECT_NE(p, nullptr);
+    fftw_destroy_plan(p);
+
+    EXPECT_THROW(fftw::warm_up({{fftw::transform_kind::C2C, {}}}, fftw::ESTIMATE),
+                 std::invalid_argument);
+    EXPECT_THROW(fftw::warm_up({{fftw::transform_kind::C2C, {4, 0}}}, fftw::ESTIMATE),
+                 std::invalid_argument);
+}
+
+TEST(Wisdom, WisdomOnlyWithoutWisdomThrows) {
+    fftw::wisdom::forget();
+    const auto flags = fftw::MEASURE | fftw::WISDOM_ONLY;
+
+    fftw::buffer in(24), out(24);
+    EXPECT_THROW(fftw::plan<1u>::dft(in, out, fftw::FORWARD, flags), std::runtime_error);
+
+    fftw::mdbuffer<2u> batch_in{3, 8}, batch_out{3, 8};
+    EXPECT_THROW(fftw::batched_plan<1u>::dft(batch_in.to_mdspan(), batch_out.to_mdspan(),
+                                             fftw::FORWARD, flags),
+                 std::runtime_error);
+
+    fftw::rbuffer real_in(24), real_out(24);
+    EXPECT_THROW(fftw::plan_r2r<1u>::dft(real_in, real_out, fftw::R2RKind::REDFT10, flags),
+                 std::runtime_error);
+
+    // the cache does not keep a plan it failed to create
+    fftw::plan_cache cache;
+    EXPECT_THROW(cache.get<fftw::plan<>>(in, out, fftw::FORWARD, flags), std::runtime_error);
+    EXPECT_EQ(cache.stats().size, 0u);
+}
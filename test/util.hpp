@@ -1,9 +1,17 @@
 #pragma once
 
+#include <filesystem>
 #include <gmock/gmock.h>
 
 constexpr double TOLERANCE = 1e-10;
 
+/// A path in the temporary directory, with any file left there by an earlier run removed.
+inline std::filesystem::path temp_path(const char *name) {
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove(path);
+    return path;
+}
+
 MATCHER_P(IsComplexNear, val, "near " + ::testing::PrintToString(val)) {
     if (std::abs(arg - val) > TOLERANCE) {
         *result_listener << arg;